@@ -7,6 +7,8 @@ See accompanied file licence.txt for license information.
 #ifndef VALIDATORS_HPP
 #define VALIDATORS_HPP
 
+#include <lan7430conf/lan7430conf.hpp>
+
 #include <filesystem>
 
 #if __has_include(<cli11/CLI11.hpp>)
@@ -15,8 +17,6 @@ See accompanied file licence.txt for license information.
 #include <CLI/CLI.hpp>
 #endif
 
-#include <regex>
-
 
 namespace detail {
 
@@ -39,19 +39,15 @@ public:
 };
 
 class MacValidator : public CLI::Validator
-// checks whether the given path is reachable
+// checks whether the given string is a MAC address accepted by stringToMac
 {
 public:
     MacValidator()
     : Validator("MAC")
     {
         func_ = [](std::string& mac) {
-            std::regex rx(
-                R"(^(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])([0-9A-Fa-f]{2})$)",
-                std::regex::icase);
-            std::smatch match;
-
-            if (!std::regex_match(mac, match, rx))
+            Mac parsed;
+            if (parseMac(mac, parsed))
             {
                 return "Mac is not valid: " + mac;
             }
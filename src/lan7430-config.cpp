@@ -1,16 +1,36 @@
 #include "validators.hpp"
 #include "version.hpp"
 
+#include <lan7430conf/audit.hpp>
+#include <lan7430conf/batch.hpp>
+#include <lan7430conf/container.hpp>
+#include <lan7430conf/eepromfile.hpp>
 #include <lan7430conf/errors.hpp>
 #include <lan7430conf/lan7430conf.hpp>
+#include <lan7430conf/latency.hpp>
+#include <lan7430conf/ledger.hpp>
+#include <lan7430conf/lot.hpp>
+#include <lan7430conf/mac48.hpp>
+#include <lan7430conf/profile.hpp>
+#include <lan7430conf/server.hpp>
+#include <lan7430conf/stream.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <filesystem>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
 
 #if __has_include(<cli11/CLI11.hpp>)
 #include <cli11/CLI11.hpp>
 #elif __has_include(<CLI/CLI.hpp>)
 #include <CLI/CLI.hpp>
 #endif
+#include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/spdlog.h>
 
 #include <cstddef>
@@ -27,6 +47,7 @@ struct ConfigureCommandParameters
 struct MacCommandParameters
 {
     std::string macAddress;
+    std::string ledgerPath;
 };
 struct LedCommandParameters
 {
@@ -37,11 +58,198 @@ struct LedCommandParameters
     LED_COMBINE combineFeature;
     LED_BLINK_PULSE_STRETCH blinkPulseStretch;
 };
+struct ProfileCommandParameters
+{
+    std::string profile;
+};
+struct InterruptsCommandParameters
+{
+    unsigned int msiVectors;
+    unsigned int msixVectors;
+};
+struct LatencyCommandParameters
+{
+    L0S_ACCEPTABLE_LATENCY l0sAcceptable;
+    L1_ACCEPTABLE_LATENCY l1Acceptable;
+    L0S_EXIT_LATENCY l0sExit;
+    L1_EXIT_LATENCY l1Exit;
+};
+struct L12TimingCommandParameters
+{
+    uint32_t tPowerOn;
+    uint32_t commonModeRestoreTime;
+};
+struct BatchCommandParameters
+{
+    std::string macStart;
+    size_t count;
+    std::string outputDirectory;
+    std::string containerPath;
+    std::string lotPath;
+    unsigned int threads;
+};
+struct LedgerCommandParameters
+{
+    std::string ledgerPath;
+    std::string firstMacAddress;
+    std::string lastMacAddress;
+};
+struct AuditCommandParameters
+{
+    std::vector<std::string> paths;
+    unsigned int threads;
+};
+struct AnalyzeCommandParameters
+{
+    std::vector<std::string> paths;
+    LatencyBudget budget;
+    unsigned int threads;
+};
+struct ServeCommandParameters
+{
+    std::string socketPath;
+};
+struct StreamCommandParameters
+{
+    std::string inputPath;
+    STREAM_FORMAT format{ STREAM_FORMAT::JSON };
+    size_t queueDepth{ 16 };
+};
 struct InfoCommandParameters
 {
     std::string filePath;
+    std::string macAddress;
+};
+
+// names of the latency values, used by the latency command and by info
+static const std::vector<std::pair<std::string, L0S_ACCEPTABLE_LATENCY>> gs_l0sAcceptableNames{
+    { "64ns", L0S_ACCEPTABLE_LATENCY::NANO_SECONDS_64 },
+    { "128ns", L0S_ACCEPTABLE_LATENCY::NANO_SECONDS_128 },
+    { "256ns", L0S_ACCEPTABLE_LATENCY::NANO_SECONDS_256 },
+    { "512ns", L0S_ACCEPTABLE_LATENCY::NANO_SECONDS_512 },
+    { "1us", L0S_ACCEPTABLE_LATENCY::MICRO_SECONDS_1 },
+    { "2us", L0S_ACCEPTABLE_LATENCY::MICRO_SECONDS_2 },
+    { "4us", L0S_ACCEPTABLE_LATENCY::MICRO_SECONDS_4 },
+    { "NoLimit", L0S_ACCEPTABLE_LATENCY::NO_LIMIT },
+};
+static const std::vector<std::pair<std::string, L1_ACCEPTABLE_LATENCY>> gs_l1AcceptableNames{
+    { "1us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_1 },
+    { "2us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_2 },
+    { "4us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_4 },
+    { "8us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_8 },
+    { "16us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_16 },
+    { "32us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_32 },
+    { "64us", L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_64 },
+    { "NoLimit", L1_ACCEPTABLE_LATENCY::NO_LIMIT },
+};
+static const std::vector<std::pair<std::string, L0S_EXIT_LATENCY>> gs_l0sExitNames{
+    { "64ns", L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_64 },
+    { "128ns", L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_128 },
+    { "256ns", L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_256 },
+    { "512ns", L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_512 },
+    { "1us", L0S_EXIT_LATENCY::BELOW_MICRO_SECONDS_1 },
+    { "2us", L0S_EXIT_LATENCY::BELOW_MICRO_SECONDS_2 },
+    { "4us", L0S_EXIT_LATENCY::UP_TO_MICRO_SECONDS_4 },
+    { "Above4us", L0S_EXIT_LATENCY::ABOVE_MICRO_SECONDS_4 },
+};
+static const std::vector<std::pair<std::string, L1_EXIT_LATENCY>> gs_l1ExitNames{
+    { "1us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_1 },
+    { "2us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_2 },
+    { "4us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_4 },
+    { "8us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_8 },
+    { "16us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_16 },
+    { "32us", L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_32 },
+    { "64us", L1_EXIT_LATENCY::UP_TO_MICRO_SECONDS_64 },
+    { "Above64us", L1_EXIT_LATENCY::ABOVE_MICRO_SECONDS_64 },
 };
 
+template<typename T>
+static std::string valueName(const std::vector<std::pair<std::string, T>>& names, T value)
+{
+    for (const auto& [name, candidate] : names)
+    {
+        if (candidate == value)
+        {
+            return name;
+        }
+    }
+    return std::to_string(static_cast<uint32_t>(value));
+}
+
+// the running server of the serve command, stopped by SIGINT/SIGTERM
+static EepromServer* gs_server = nullptr;
+
+static void stopServer(int /* signal */)
+{
+    if (gs_server != nullptr)
+    {
+        gs_server->stop();
+    }
+}
+
+// Moves the options of configure that were given after one of its subcommands (e.g.
+// "configure mac ... -o out.bin") in front of that subcommand. configure has no fallthrough so
+// that mac/led can be repeated, which means CLI11 would reject them at their original position.
+// Options the current subcommand defines itself are left in place.
+static std::vector<std::string> hoistConfigureOptions(CLI::App& configure,
+                                                      const std::vector<std::string>& args)
+{
+    std::vector<std::string> result;
+    std::vector<std::string> hoisted;
+    auto configureIt = args.end();
+    CLI::App* subcommand = nullptr;
+    for (auto it = args.begin(); it != args.end(); ++it)
+    {
+        if (configureIt == args.end() || *it == "--")
+        {
+            if (configureIt == args.end() && *it == configure.get_name())
+            {
+                configureIt = it;
+            }
+            result.push_back(*it);
+            continue;
+        }
+
+        const auto found = configure.get_subcommands(
+            [&it](const CLI::App* candidate) { return candidate->get_name() == *it; });
+        if (!found.empty())
+        {
+            subcommand = found.front();
+            result.push_back(*it);
+            continue;
+        }
+
+        // --name, --name=value, -n or -nvalue
+        const bool isLong = it->compare(0, 2, "--") == 0;
+        const bool isShort = !isLong && it->size() >= 2 && (*it)[0] == '-';
+        const std::string name
+            = isLong ? it->substr(0, it->find('=')) : (isShort ? it->substr(0, 2) : std::string{});
+        const bool inlineValue = isLong ? it->find('=') != std::string::npos : it->size() > 2;
+        CLI::Option* option = name.empty() ? nullptr : configure.get_option_no_throw(name);
+        const bool separateValue = option != nullptr && option->get_type_size() != 0 && !inlineValue;
+        if (subcommand == nullptr || option == nullptr
+            || subcommand->get_option_no_throw(name) != nullptr
+            || (separateValue && std::next(it) == args.end()))
+        {
+            result.push_back(*it);
+            continue;
+        }
+
+        hoisted.push_back(*it);
+        if (separateValue)
+        {
+            hoisted.push_back(*++it);
+        }
+    }
+
+    if (configureIt != args.end())
+    {
+        const auto position = std::next(result.begin(), std::distance(args.begin(), configureIt) + 1);
+        result.insert(position, hoisted.begin(), hoisted.end());
+    }
+    return result;
+}
+
 int main(int argc, char const* argv[])
 {
     spdlog::set_pattern("%v");
@@ -62,6 +270,11 @@ int main(int argc, char const* argv[])
     ConfigureCommandParameters configParams{};
     configParams.outputPath = "lan7430_config.bin";
     auto configCommand = app.add_subcommand("configure");
+    // mac/led can be chained and repeated (led 0 ... led 1 ...), their changes are applied
+    // together. Without fallthrough a repeated subcommand ends the previous occurrence and is
+    // dispatched by configure, the options of configure given after mac/led are moved in front
+    // of them by hoistConfigureOptions
+    configCommand->require_subcommand(/* min */ 0, /* max */ 0)->fallthrough(false);
     auto cInputOption = configCommand
                             ->add_option("-i,--input",
                                          configParams.inputPath,
@@ -86,43 +299,102 @@ int main(int argc, char const* argv[])
                                  },
                                  CLI::ignore_case));
 
+    auto cPatchFlag
+        = configCommand
+              ->add_flag("--patch",
+                         "Modify the existing output file in place, only the changed bytes are "
+                         "written and bits unknown to this tool are preserved")
+              ->excludes(cInputOption);
+
     // read/write helpers
     auto readConfig = [&]() {
         EEPROM_CONFIG config{};
         if (*cInputOption)
         {
-            EEPROM eeprom = readEEPROM(configParams.inputPath);
-            config = eepromConfigToEEPROM(eeprom);
+            config = eepromConfigToEEPROM(EepromFile(configParams.inputPath).eeprom());
         }
         else if (std::filesystem::exists(configParams.outputPath))
         {
-            EEPROM eeprom = readEEPROM(configParams.outputPath);
-            config = eepromConfigToEEPROM(eeprom);
+            config = eepromConfigToEEPROM(EepromFile(configParams.outputPath).eeprom());
         }
         return config;
     };
-    auto writeConfig = [&](const EEPROM_CONFIG& config) {
-        // the user can give us different input/output paths.
-        // we set the inputPath = outputPath here, so following command callbacks
-        // work with the created file from now on...
-        if (*cInputOption)
+    // the commands only collect their changes, which are applied in a single transaction by the
+    // configure callback, as it runs after the callbacks of its subcommands:
+    // the file is read once and written once (atomically, or in place with --patch)
+    std::vector<std::function<void(EepromRef&)>> edits;
+    auto editEEPROM = [&](std::function<void(EepromRef&)> edit) {
+        edits.push_back(std::move(edit));
+    };
+    // ledger of mac --auto, the address is allocated after all other edits were applied and the
+    // image was checked, so a failing edit doesn't use up an address
+    std::string autoMacLedger;
+    auto commitEdits = [&]() {
+        std::optional<Mac> allocated;
+        const auto applyEdits = [&](EepromRef& ref) {
+            for (const auto& edit : edits)
+            {
+                edit(ref);
+            }
+            if (autoMacLedger.empty())
+            {
+                return;
+            }
+            MacLedger ledger(autoMacLedger);
+            // everything but the MAC address, which is not allocated yet
+            EEPROM check = ref.eeprom();
+            check.mac = ledger.first();
+            validateEEPROM(check);
+
+            allocated = ledger.allocate();
+            SPDLOG_INFO("Allocated MAC {} from {}", macToString(*allocated), autoMacLedger);
+            ref.setMac(*allocated);
+        };
+
+        try
         {
-            configParams.inputPath = configParams.outputPath;
+            if (*cPatchFlag)
+            {
+                // in place, there is nothing to do without changes
+                if (!edits.empty() || !autoMacLedger.empty())
+                {
+                    [[maybe_unused]] const size_t written
+                        = patchEEPROM(configParams.outputPath, applyEdits);
+                    SPDLOG_DEBUG("Patched {} bytes of {}", written, configParams.outputPath);
+                }
+                return;
+            }
+
+            EEPROM eeprom = createEEPROM(readConfig());
+            EepromRef ref(eeprom);
+            applyEdits(ref);
+            replaceEEPROM(configParams.outputPath, eeprom);
+        }
+        catch (const ifm::error_type&)
+        {
+            if (allocated)
+            {
+                SPDLOG_ERROR("MAC {} was allocated from {} but not written",
+                             macToString(*allocated),
+                             autoMacLedger);
+            }
+            throw;
         }
-        writeEEPROM(configParams.outputPath, config);
     };
 
     configCommand->callback([&]() {
+        // the batch subcommand writes its own files, there is no single output file to update
+        if (configCommand->got_subcommand("batch"))
+        {
+            return;
+        }
         try
         {
-            EEPROM_CONFIG config = readConfig();
-
             if (*cMemoryOption)
             {
-                config.magic = configParams.magic;
+                editEEPROM([&](EepromRef& ref) { ref.setMagic(configParams.magic); });
             }
-
-            writeConfig(config);
+            commitEdits();
         }
         catch (ifm::error_type e)
         {
@@ -138,18 +410,34 @@ int main(int argc, char const* argv[])
     MacCommandParameters macParams{};
     CLI::App* macCommand
         = configCommand->add_subcommand("mac", "Allows configuring the mac address");
+    macCommand->validate_positionals()->immediate_callback();
     auto mMacOption
         = macCommand
               ->add_option("mac,-m,--mac", macParams.macAddress, "MAC address (00:00:00:00:00:00)")
-              ->check(ValidMac)
-              ->required();
+              ->check(ValidMac);
+    auto mLedgerOption = macCommand
+                             ->add_option("--ledger",
+                                          macParams.ledgerPath,
+                                          "Ledger file the MAC address is allocated from")
+                             ->check(CLI::ExistingFile);
+    auto mAutoFlag = macCommand
+                         ->add_flag("--auto", "Use the next free MAC address of the ledger")
+                         ->needs(mLedgerOption)
+                         ->excludes(mMacOption);
 
     macCommand->callback([&]() {
+        if (!*mMacOption && !*mAutoFlag)
+        {
+            throw CLI::RequiredError("mac or --auto");
+        }
         try
         {
-            EEPROM_CONFIG config = readConfig();
-
-            if (*mMacOption)
+            if (*mAutoFlag)
+            {
+                // allocated when the transaction is committed, see commitEdits
+                autoMacLedger = macParams.ledgerPath;
+            }
+            else if (*mMacOption)
             {
                 // remove any whitespace
                 macParams.macAddress.erase(
@@ -158,10 +446,9 @@ int main(int argc, char const* argv[])
                                    [l = std::locale{}](auto ch) { return std::isspace(ch, l); }),
                     macParams.macAddress.end());
 
-                config.mac = stringToMac(macParams.macAddress);
+                const Mac mac = stringToMac(macParams.macAddress);
+                editEEPROM([mac](EepromRef& ref) { ref.setMac(mac); });
             }
-
-            writeConfig(config);
         }
         catch (ifm::error_type e)
         {
@@ -177,6 +464,7 @@ int main(int argc, char const* argv[])
     LedCommandParameters ledParams{};
     CLI::App* ledCommand
         = configCommand->add_subcommand("led", "Allows configuring the parameters of the LEDs");
+    ledCommand->validate_positionals()->immediate_callback();
     ledCommand->add_option("id,--id", ledParams.id, "ID of the LED you want to configure")
         ->check(CLI::Range(0, 3))
         ->required();
@@ -235,39 +523,720 @@ int main(int argc, char const* argv[])
                                 CLI::ignore_case));
 
     ledCommand->callback([&]() {
+        try
+        {
+            assert(ledParams.id >= 0);
+            assert(ledParams.id < std::tuple_size<decltype(EEPROM_CONFIG::ledConfig)>::value);
+
+            // the field descriptors are compile time constants, pick the one of the LED
+            auto setLed = [id = ledParams.id](EepromRef& ref, auto value, const auto&... leds) {
+                int i = 0;
+                ((i++ == id ? ref.set(leds, value) : void()), ...);
+            };
+            // led may be given more than once, keep what this occurrence has set
+            editEEPROM([setLed,
+                        led = ledParams,
+                        enable = bool(*lEnableFlag),
+                        polarity = bool(*lPolarityOption),
+                        control = bool(*lControlOption),
+                        combine = bool(*lCombineOption),
+                        blink = bool(*lBlinkOption)](EepromRef& ref) {
+                using namespace fields;
+                if (enable)
+                {
+                    setLed(ref, led.enable, led0Enable, led1Enable, led2Enable, led3Enable);
+                }
+                if (polarity)
+                {
+                    setLed(ref,
+                           led.polarity,
+                           led0Polarity,
+                           led1Polarity,
+                           led2Polarity,
+                           led3Polarity);
+                }
+                if (control)
+                {
+                    setLed(
+                        ref, led.control, led0Control, led1Control, led2Control, led3Control);
+                }
+                if (combine)
+                {
+                    setLed(ref,
+                           led.combineFeature,
+                           led0Combine,
+                           led1Combine,
+                           led2Combine,
+                           led3Combine);
+                }
+                if (blink)
+                {
+                    setLed(ref,
+                           led.blinkPulseStretch,
+                           led0BlinkPulseStretch,
+                           led1BlinkPulseStretch,
+                           led2BlinkPulseStretch,
+                           led3BlinkPulseStretch);
+                }
+            });
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand led: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** PROFILE COMMAND ********
+     *****************************************/
+    ProfileCommandParameters profileParams{};
+    std::string profileNames;
+    for (const auto& profile : builtinProfiles())
+    {
+        profileNames += "\n  " + profile.name + ": " + profile.description;
+    }
+    CLI::App* profileCommand = configCommand->add_subcommand(
+        "profile", "Applies a set of settings in one step and prints what changed");
+    profileCommand->validate_positionals()->immediate_callback();
+    profileCommand
+        ->add_option("profile,-p,--profile",
+                     profileParams.profile,
+                     "Built in profile or path of a profile file (JSON object of EEPROM_CONFIG "
+                     "members and values):"
+                         + profileNames)
+        ->required();
+
+    profileCommand->callback([&]() {
+        try
+        {
+            editEEPROM([profile = findProfile(profileParams.profile)](EepromRef& ref) {
+                const std::vector<FieldChange> changes = applyProfile(profile, ref);
+                SPDLOG_INFO("Profile {}: {} changes", profile.name, changes.size());
+                for (const auto& change : changes)
+                {
+                    if (change.name == "mac")
+                    {
+                        SPDLOG_INFO("  mac: {} -> {}",
+                                    Mac48(change.before).toString(),
+                                    Mac48(change.after).toString());
+                        continue;
+                    }
+                    SPDLOG_INFO("  {}: {} -> {}{}",
+                                change.name,
+                                change.before,
+                                change.after,
+                                change.overridden ? " (override)" : "");
+                }
+            });
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand profile: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** INTERRUPTS COMMAND *****
+     *****************************************/
+    InterruptsCommandParameters interruptsParams{};
+    CLI::App* interruptsCommand = configCommand->add_subcommand(
+        "interrupts", "Allows configuring the number of MSI and MSI-X vectors of the device");
+    interruptsCommand->validate_positionals()->immediate_callback();
+    // plain vector counts, the transformers of the other commands would also take the raw values
+    auto iMsiOption = interruptsCommand
+                          ->add_option("--msi-vectors",
+                                       interruptsParams.msiVectors,
+                                       "MSI Multiple Message Capable, 1 keeps the hardware default")
+                          ->check(CLI::IsMember({ 1, 2, 4, 8, 16, 32 }));
+    auto iMsixOption = interruptsCommand
+                           ->add_option("--msix-vectors",
+                                        interruptsParams.msixVectors,
+                                        "MSI-X Table Size, 1 keeps the hardware default")
+                           ->check(CLI::Range(1, 8));
+    interruptsCommand->require_option(1, 2);
+
+    interruptsCommand->callback([&]() {
+        editEEPROM([interrupts = interruptsParams,
+                    msi = bool(*iMsiOption),
+                    msix = bool(*iMsixOption)](EepromRef& ref) {
+            if (msi)
+            {
+                uint32_t exponent = 0;
+                while ((1u << exponent) < interrupts.msiVectors)
+                {
+                    ++exponent;
+                }
+                ref.set(fields::msiMultipleMessageCapable,
+                        static_cast<MSI_MULTIPLE_MESSAGE_CAPABLE>(exponent));
+            }
+            if (msix)
+            {
+                ref.set(fields::msixTableSize,
+                        static_cast<MSIX_TABLE_SIZE>(interrupts.msixVectors - 1));
+            }
+        });
+    });
+
+
+    /*****************************************
+     **************** LATENCY COMMAND ********
+     *****************************************/
+    LatencyCommandParameters latencyParams{};
+    CLI::App* latencyCommand = configCommand->add_subcommand(
+        "latency",
+        "Allows configuring the acceptable and exit latencies the endpoint reports for ASPM L0s "
+        "and L1, the exit latencies are upper bounds");
+    latencyCommand->validate_positionals()->immediate_callback();
+    auto laL0sAcceptableOption
+        = latencyCommand
+              ->add_option("--l0s-acceptable",
+                           latencyParams.l0sAcceptable,
+                           "Endpoint L0s Acceptable Latency, 64ns keeps the hardware default")
+              ->transform(CLI::CheckedTransformer(gs_l0sAcceptableNames, CLI::ignore_case));
+    auto laL1AcceptableOption
+        = latencyCommand
+              ->add_option("--l1-acceptable",
+                           latencyParams.l1Acceptable,
+                           "Endpoint L1 Acceptable Latency, 1us keeps the hardware default")
+              ->transform(CLI::CheckedTransformer(gs_l1AcceptableNames, CLI::ignore_case));
+    auto laL0sExitOption
+        = latencyCommand
+              ->add_option("--l0s-exit",
+                           latencyParams.l0sExit,
+                           "L0s Exit Latency, 64ns keeps the hardware default")
+              ->transform(CLI::CheckedTransformer(gs_l0sExitNames, CLI::ignore_case));
+    auto laL1ExitOption
+        = latencyCommand
+              ->add_option("--l1-exit",
+                           latencyParams.l1Exit,
+                           "L1 Exit Latency, 1us keeps the hardware default")
+              ->transform(CLI::CheckedTransformer(gs_l1ExitNames, CLI::ignore_case));
+    latencyCommand->require_option(1, 4);
+
+    latencyCommand->callback([&]() {
+        editEEPROM([latency = latencyParams,
+                    l0sAcceptable = bool(*laL0sAcceptableOption),
+                    l1Acceptable = bool(*laL1AcceptableOption),
+                    l0sExit = bool(*laL0sExitOption),
+                    l1Exit = bool(*laL1ExitOption)](EepromRef& ref) {
+            if (l0sAcceptable)
+            {
+                ref.set(fields::l0sAcceptableLatency, latency.l0sAcceptable);
+            }
+            if (l1Acceptable)
+            {
+                ref.set(fields::l1AcceptableLatency, latency.l1Acceptable);
+            }
+            if (l0sExit)
+            {
+                ref.set(fields::l0sExitLatency, latency.l0sExit);
+            }
+            if (l1Exit)
+            {
+                ref.set(fields::l1ExitLatency, latency.l1Exit);
+            }
+        });
+    });
+
+
+    /*****************************************
+     **************** L1.2 TIMING COMMAND ****
+     *****************************************/
+    L12TimingCommandParameters l12Params{};
+    CLI::App* l12Command = configCommand->add_subcommand(
+        "l12-timing", "Allows configuring the time the port needs to leave ASPM/PCI-PM L1.2");
+    l12Command->validate_positionals()->immediate_callback();
+    auto tTPowerOnOption
+        = l12Command
+              ->add_option("--t-power-on",
+                           l12Params.tPowerOn,
+                           "Port T_POWER_ON in us, rounded up to the next value that can be "
+                           "encoded (2 us steps up to 62 us, 10 us up to 310 us, 100 us above)")
+              ->check(CLI::Range(0u, t_power_on_max));
+    auto tCommonModeOption = l12Command
+                                 ->add_option("--common-mode-restore-time",
+                                              l12Params.commonModeRestoreTime,
+                                              "Port Common_Mode_Restore_Time in us")
+                                 ->check(CLI::Range(0u, common_mode_restore_time_max));
+    l12Command->require_option(1, 2);
+
+    l12Command->callback([&]() {
+        try
+        {
+            // encode the times once, the edit only copies the fields
+            EEPROM_CONFIG timing{};
+            setTPowerOn(timing, l12Params.tPowerOn);
+            setCommonModeRestoreTime(timing, l12Params.commonModeRestoreTime);
+            if (*tTPowerOnOption && tPowerOnMicroSeconds(timing) != l12Params.tPowerOn)
+            {
+                SPDLOG_INFO("T_POWER_ON {} us is rounded up to {} us",
+                            l12Params.tPowerOn,
+                            tPowerOnMicroSeconds(timing));
+            }
+            editEEPROM([timing,
+                        tPowerOn = bool(*tTPowerOnOption),
+                        commonMode = bool(*tCommonModeOption)](EepromRef& ref) {
+                if (tPowerOn)
+                {
+                    ref.set(fields::tPowerOnValue, timing.tPowerOnValue);
+                    ref.set(fields::tPowerOnScale, timing.tPowerOnScale);
+                }
+                if (commonMode)
+                {
+                    ref.set(fields::commonModeRestoreTime, timing.commonModeRestoreTime);
+                }
+            });
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand l12-timing: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** BATCH COMMAND **********
+     *****************************************/
+    BatchCommandParameters batchParams{};
+    batchParams.outputDirectory = ".";
+    CLI::App* batchCommand = configCommand->add_subcommand(
+        "batch", "Creates one EEPROM file per MAC address of a consecutive range");
+    batchCommand->fallthrough()
+        ->excludes(macCommand)
+        ->excludes(ledCommand)
+        ->excludes(profileCommand)
+        ->excludes(interruptsCommand)
+        ->excludes(latencyCommand)
+        ->excludes(l12Command);
+    batchCommand
+        ->add_option("--mac-start", batchParams.macStart, "First MAC address of the range")
+        ->check(ValidMac)
+        ->required();
+    batchCommand->add_option("--count", batchParams.count, "Number of EEPROM files to create")
+        ->check(CLI::Range(size_t(1), size_t(1) << 48))
+        ->required();
+    auto bOutDirOption = batchCommand
+                             ->add_option("--out-dir",
+                                          batchParams.outputDirectory,
+                                          "Directory the <MAC>-pad.bin files are written to")
+                             ->capture_default_str()
+                             ->check(CLI::ExistingDirectory);
+    auto bContainerOption
+        = batchCommand
+              ->add_option("--container",
+                           batchParams.containerPath,
+                           "Write all images into a single container file instead of one file "
+                           "per MAC address")
+              ->check(ExistingPath)
+              ->excludes(bOutDirOption);
+    auto bLotOption
+        = batchCommand
+              ->add_option("--lot",
+                           batchParams.lotPath,
+                           "Write the image once and only the MAC addresses into a lot file")
+              ->check(ExistingPath)
+              ->excludes(bOutDirOption)
+              ->excludes(bContainerOption);
+    batchCommand
+        ->add_option("-j,--threads",
+                     batchParams.threads,
+                     "Number of worker threads, 0 uses one thread per core")
+        ->capture_default_str();
+
+    batchCommand->callback([&]() {
         try
         {
             EEPROM_CONFIG config = readConfig();
+            if (*cMemoryOption)
+            {
+                config.magic = configParams.magic;
+            }
 
-            assert(ledParams.id >= 0);
-            assert(ledParams.id < config.ledConfig.size());
+            // the template is encoded only once, afterwards only the MAC bytes are patched
+            EEPROM eeprom = createEEPROM(config);
+            const Mac macStart = stringToMac(batchParams.macStart);
 
-            if (*lEnableFlag)
+            const auto start = std::chrono::steady_clock::now();
+            if (*bContainerOption)
             {
-                config.ledConfig[ledParams.id].enable = ledParams.enable;
+                const MacRange range(macStart, batchParams.count);  // fail before allocating
+                std::vector<EEPROM> images(range.size(), eeprom);
+                for (size_t i = 0; i < images.size(); ++i)
+                {
+                    images[i].mac = range.first() + i;
+                }
+                writeEEPROMContainer(batchParams.containerPath, images);
             }
-            if (*lPolarityOption)
+            else if (*bLotOption)
             {
-                config.ledConfig[ledParams.id].polarity = ledParams.polarity;
+                const MacRange range(macStart, batchParams.count);  // fail before allocating
+                std::vector<Mac> macs(range.begin(), range.end());
+                writeEEPROMLot(batchParams.lotPath, EepromLot(eeprom, std::move(macs)));
             }
-            if (*lControlOption)
+            else
             {
-                config.ledConfig[ledParams.id].control = ledParams.control;
+                writeEEPROMBatch(batchParams.outputDirectory,
+                                 eeprom,
+                                 macStart,
+                                 batchParams.count,
+                                 batchParams.threads);
             }
-            if (*lCombineOption)
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            SPDLOG_INFO("Created {} EEPROM images in {} ({:.3f}s, {:.0f} images/s)",
+                        batchParams.count,
+                        *bContainerOption ? batchParams.containerPath
+                        : *bLotOption     ? batchParams.lotPath
+                                          : batchParams.outputDirectory,
+                        elapsed.count(),
+                        batchParams.count / std::max(elapsed.count(), 1e-9));
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand batch: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** LEDGER COMMAND *********
+     *****************************************/
+    LedgerCommandParameters ledgerParams{};
+    auto ledgerCommand = app.add_subcommand(
+        "ledger", "Manages a ledger file MAC addresses are allocated from (configure mac --auto)");
+    ledgerCommand->require_subcommand(1);
+
+    auto ledgerCreateCommand
+        = ledgerCommand->add_subcommand("create", "Creates a ledger for a range of MAC addresses");
+    ledgerCreateCommand
+        ->add_option("ledger,-l,--ledger", ledgerParams.ledgerPath, "Path of the ledger file")
+        ->check(ExistingPath)
+        ->required();
+    ledgerCreateCommand
+        ->add_option("--first", ledgerParams.firstMacAddress, "First MAC address of the range")
+        ->check(ValidMac)
+        ->required();
+    ledgerCreateCommand
+        ->add_option("--last", ledgerParams.lastMacAddress, "Last MAC address of the range")
+        ->check(ValidMac)
+        ->required();
+    ledgerCreateCommand->callback([&]() {
+        try
+        {
+            MacLedger::create(ledgerParams.ledgerPath,
+                              stringToMac(ledgerParams.firstMacAddress),
+                              stringToMac(ledgerParams.lastMacAddress));
+            SPDLOG_INFO("Created ledger at: {}", ledgerParams.ledgerPath);
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand ledger create: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+    auto ledgerStatusCommand
+        = ledgerCommand->add_subcommand("status", "Dumps the state of a ledger to console");
+    ledgerStatusCommand
+        ->add_option("ledger,-l,--ledger", ledgerParams.ledgerPath, "Path of the ledger file")
+        ->check(CLI::ExistingFile)
+        ->required();
+    ledgerStatusCommand->callback([&]() {
+        try
+        {
+            const MacLedger ledger(ledgerParams.ledgerPath);
+            SPDLOG_INFO("first: {}", macToString(ledger.first()));
+            SPDLOG_INFO("last: {}", macToString(ledger.last()));
+            SPDLOG_INFO("remaining: {}", ledger.remaining());
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand ledger status: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** AUDIT COMMAND **********
+     *****************************************/
+    AuditCommandParameters auditParams{};
+    auto auditCommand
+        = app.add_subcommand("audit", "Checks EEPROM images produced by the other commands");
+    auditCommand->require_subcommand(1);
+
+    auto auditDuplicatesCommand = auditCommand->add_subcommand(
+        "duplicates",
+        "Finds MAC addresses used more than once in EEPROM, container and lot files; "
+        "exits with 1 if there are any");
+    auditDuplicatesCommand
+        ->add_option("paths",
+                     auditParams.paths,
+                     "Files and directories to check, directories are searched recursively")
+        ->check(CLI::ExistingPath)
+        ->required();
+    auditDuplicatesCommand->add_option(
+        "-j,--threads", auditParams.threads, "Number of worker threads, 0 uses all cores");
+    auditDuplicatesCommand->callback([&]() {
+        MacAuditResult result;
+        try
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            result = auditMacs(auditParams.paths, auditParams.threads);
+            const std::chrono::duration<double> duration
+                = std::chrono::steady_clock::now() - startTime;
+
+            for (const auto& filePath : result.skipped)
             {
-                config.ledConfig[ledParams.id].combineFeature = ledParams.combineFeature;
+                SPDLOG_ERROR("Skipped {}: not an EEPROM, container or lot file", filePath);
             }
-            if (*lBlinkOption)
+            for (const auto& duplicate : result.duplicates)
             {
-                config.ledConfig[ledParams.id].blinkPulseStretch = ledParams.blinkPulseStretch;
+                SPDLOG_INFO(
+                    "{} used {} times:", macToString(duplicate.mac), duplicate.locations.size());
+                for (const auto& location : duplicate.locations)
+                {
+                    SPDLOG_INFO("\t{}", location);
+                }
             }
+            SPDLOG_INFO("Checked {} images in {} files ({:.3f}s), {} duplicate MAC addresses",
+                        result.images,
+                        result.files,
+                        duration.count(),
+                        result.duplicates.size());
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR(
+                "Error occured in subcommand audit duplicates: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+        if (!result.duplicates.empty())
+        {
+            throw CLI::RuntimeError(1);
+        }
+    });
+
+
+    /*****************************************
+     **************** ANALYZE COMMAND ********
+     *****************************************/
+    AnalyzeCommandParameters analyzeParams{};
+    auto analyzeCommand = app.add_subcommand(
+        "analyze", "Estimates the effect of the settings of EEPROM images without installing them");
+    analyzeCommand->require_subcommand(1);
+
+    auto analyzeLatencyCommand = analyzeCommand->add_subcommand(
+        "latency",
+        "Computes the ASPM entrance and exit latencies, the L1.2 exit time and the EEE wake time "
+        "of EEPROM, container and lot files; exits with 1 if an image exceeds the budget");
+    analyzeLatencyCommand
+        ->add_option("paths",
+                     analyzeParams.paths,
+                     "Files and directories to check, directories are searched recursively")
+        ->check(CLI::ExistingPath)
+        ->required();
+    analyzeLatencyCommand->add_option(
+        "-j,--threads", analyzeParams.threads, "Number of worker threads, 0 uses all cores");
+    // the budget is given with a unit, e.g. 8us
+    const CLI::AsNumberWithUnit latencyUnit(std::map<std::string, uint64_t>{
+                                                { "ns", 1 }, { "us", 1000 }, { "ms", 1000000 } },
+                                            CLI::AsNumberWithUnit::UNIT_REQUIRED);
+    analyzeLatencyCommand
+        ->add_option("--l0s-exit", analyzeParams.budget.l0sExit, "Budget of the L0s exit latency")
+        ->transform(latencyUnit);
+    analyzeLatencyCommand
+        ->add_option("--l1-exit", analyzeParams.budget.l1Exit, "Budget of the L1 exit latency")
+        ->transform(latencyUnit);
+    analyzeLatencyCommand
+        ->add_option("--l12-exit",
+                     analyzeParams.budget.l12Exit,
+                     "Budget of the L1.2 exit latency (L1 exit, T_POWER_ON and "
+                     "Common_Mode_Restore_Time)")
+        ->transform(latencyUnit);
+    analyzeLatencyCommand
+        ->add_option("--eee-wake", analyzeParams.budget.eeeWake, "Budget of the EEE wake time")
+        ->transform(latencyUnit);
+    analyzeLatencyCommand
+        ->add_option("--wake",
+                     analyzeParams.budget.worstWake,
+                     "Budget of the worst case wake time (slowest enabled link state and EEE)")
+        ->transform(latencyUnit);
+    analyzeLatencyCommand->add_flag(
+        "--strict",
+        analyzeParams.budget.strict,
+        "Images whose latency fields keep the hardware default exceed the budget");
+    analyzeLatencyCommand->callback([&]() {
+        LatencyAnalysis analysis;
+        try
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            analysis = analyzeLatency(
+                analyzeParams.paths, analyzeParams.budget, analyzeParams.threads);
+            const std::chrono::duration<double> duration
+                = std::chrono::steady_clock::now() - startTime;
 
-            writeConfig(config);
+            for (const auto& filePath : analysis.skipped)
+            {
+                SPDLOG_WARN("Skipped {}: not an EEPROM, container or lot file", filePath);
+            }
+            const auto exitLatency = [](uint64_t latency, bool blocked) {
+                return latencyToString(latency) + (blocked ? " (not enabled)" : "");
+            };
+            for (const auto& report : analysis.reports)
+            {
+                const LatencyFigures& figures = report.figures;
+                SPDLOG_INFO("{} ({} images):", report.location, report.images);
+                SPDLOG_INFO("\tL0s entrance: {} exit: {} acceptable: {}",
+                            latencyToString(figures.l0sEntrance),
+                            exitLatency(figures.l0sExit, figures.l0sBlocked),
+                            latencyToString(figures.l0sAcceptable));
+                SPDLOG_INFO("\tL1 entrance: {} exit: {} acceptable: {} L1.2 exit: {}",
+                            latencyToString(figures.l1Entrance),
+                            exitLatency(figures.l1Exit, figures.l1Blocked),
+                            latencyToString(figures.l1Acceptable),
+                            figures.l12Enabled ? latencyToString(figures.l12Exit) : "off");
+                SPDLOG_INFO("\tEEE wake: {} worst case wake: {}",
+                            latencyToString(figures.eeeWake),
+                            latencyToString(figures.worstWake));
+                if (!figures.defaults.empty())
+                {
+                    std::string defaults;
+                    for (const auto& name : figures.defaults)
+                    {
+                        defaults += (defaults.empty() ? "" : ", ") + name;
+                    }
+                    SPDLOG_INFO("\thardware default: {}", defaults);
+                }
+                for (const auto& violation : report.violations)
+                {
+                    SPDLOG_ERROR("\t{} exceeds the budget", violation);
+                }
+            }
+            SPDLOG_INFO("Checked {} images in {} files ({:.3f}s), {} images exceed the budget",
+                        analysis.images,
+                        analysis.files,
+                        duration.count(),
+                        analysis.violations);
         }
         catch (ifm::error_type e)
         {
-            SPDLOG_ERROR("Error occured in subcommand led: {} - {}", e.code(), e.what());
+            SPDLOG_ERROR(
+                "Error occured in subcommand analyze latency: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+        // a file that can't be checked mustn't pass the gate
+        if (analysis.violations != 0 || !analysis.skipped.empty())
+        {
+            throw CLI::RuntimeError(1);
+        }
+    });
+
+
+    /*****************************************
+     **************** SERVE COMMAND **********
+     *****************************************/
+    ServeCommandParameters serveParams{};
+    auto serveCommand = app.add_subcommand(
+        "serve",
+        "Creates EEPROM images for the requests (template + MAC address) received on a Unix "
+        "socket until SIGINT/SIGTERM, see lan7430conf/server.hpp for the protocol");
+    serveCommand
+        ->add_option("-s,--socket", serveParams.socketPath, "Path of the Unix socket to listen on")
+        ->required();
+    serveCommand->callback([&]() {
+        try
+        {
+            EepromServer server(serveParams.socketPath);
+            gs_server = &server;
+            std::signal(SIGINT, stopServer);
+            std::signal(SIGTERM, stopServer);
+            SPDLOG_INFO("Listening on {}", serveParams.socketPath);
+            server.run();
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            gs_server = nullptr;
+
+            using us = std::chrono::duration<double, std::micro>;
+            const ServerStatistics statistics = server.statistics();
+            SPDLOG_INFO("Served {} requests ({} errors) on {} connections",
+                        statistics.requests,
+                        statistics.errors,
+                        statistics.connections);
+            SPDLOG_INFO("Latency p50 {:.1f}us, p90 {:.1f}us, p99 {:.1f}us, p99.9 {:.1f}us, "
+                        "max {:.1f}us",
+                        us(statistics.p50).count(),
+                        us(statistics.p90).count(),
+                        us(statistics.p99).count(),
+                        us(statistics.p999).count(),
+                        us(statistics.max).count());
+        }
+        catch (ifm::error_type e)
+        {
+            gs_server = nullptr;
+            SPDLOG_ERROR("Error occured in subcommand serve: {} - {}", e.code(), e.what());
+            throw CLI::RuntimeError(e.what(), e.code());
+        }
+    });
+
+
+    /*****************************************
+     **************** STREAM COMMAND *********
+     *****************************************/
+    StreamCommandParameters streamParams{};
+    auto streamCommand = app.add_subcommand(
+        "stream",
+        "Creates one EEPROM image per newline delimited JSON record (EEPROM_CONFIG members) read "
+        "from stdin and writes them to stdout");
+    auto sInputOption = streamCommand
+                            ->add_option("-i,--input",
+                                         streamParams.inputPath,
+                                         "EEPROM file the records are applied to")
+                            ->check(CLI::ExistingFile);
+    streamCommand
+        ->add_option("--format", streamParams.format, "Output format of the images")
+        ->transform(CLI::CheckedTransformer(
+            std::vector<std::pair<std::string, STREAM_FORMAT>>{
+                { "binary", STREAM_FORMAT::BINARY },
+                { "json", STREAM_FORMAT::JSON },
+            },
+            CLI::ignore_case))
+        ->capture_default_str();
+    streamCommand
+        ->add_option("--queue-depth",
+                     streamParams.queueDepth,
+                     "Batches of records buffered between reading, encoding and writing")
+        ->capture_default_str();
+    streamCommand->callback([&]() {
+        // stdout belongs to the images
+        spdlog::set_default_logger(spdlog::stderr_logger_mt("stderr"));
+        std::ios::sync_with_stdio(false);
+        try
+        {
+            EEPROM_CONFIG defaults{};
+            if (*sInputOption)
+            {
+                defaults = eepromConfigToEEPROM(EepromFile(streamParams.inputPath).eeprom());
+            }
+            const auto startTime = std::chrono::steady_clock::now();
+            const StreamStatistics statistics = streamEEPROMs(
+                std::cin, std::cout, defaults, streamParams.format, streamParams.queueDepth);
+            const std::chrono::duration<double> duration
+                = std::chrono::steady_clock::now() - startTime;
+            SPDLOG_INFO("Streamed {} records ({} errors) in {:.3f}s",
+                        statistics.records,
+                        statistics.errors,
+                        duration.count());
+        }
+        catch (ifm::error_type e)
+        {
+            SPDLOG_ERROR("Error occured in subcommand stream: {} - {}", e.code(), e.what());
             throw CLI::RuntimeError(e.what(), e.code());
         }
     });
@@ -285,10 +1254,30 @@ int main(int argc, char const* argv[])
                      "Dump information about the EEPROM file to console")
         ->capture_default_str()
         ->check(CLI::ExistingFile);
+    auto iMacOption = infoCommand
+                          ->add_option("-m,--mac",
+                                       infoParams.macAddress,
+                                       "Treat the input as container or lot file and dump the "
+                                       "image of this MAC address")
+                          ->check(ValidMac);
     infoCommand->callback([&]() {
         try
         {
-            EEPROM eeprom = readEEPROM(infoParams.filePath);
+            EEPROM eeprom{};
+            if (!*iMacOption)
+            {
+                eeprom = readEEPROM(infoParams.filePath);
+            }
+            else if (EepromLot::isLot(infoParams.filePath))
+            {
+                eeprom = readEEPROMLot(infoParams.filePath)
+                             .image(stringToMac(infoParams.macAddress));
+                validateEEPROM(eeprom);
+            }
+            else
+            {
+                eeprom = readEEPROM(infoParams.filePath, stringToMac(infoParams.macAddress));
+            }
             EEPROM_CONFIG config = eepromConfigToEEPROM(eeprom);
 
             switch (EEPROM_MAGIC(eeprom.magic))
@@ -316,6 +1305,39 @@ int main(int argc, char const* argv[])
 
             SPDLOG_INFO("MAC: {}", macToString(eeprom.mac));
 
+            // these fields are only loaded by the LAN7430 if their enable bit is set
+            const EepromView view(eeprom);
+            const auto overridden = [&](const auto& field, const std::string& value) {
+                return view.enabled(field) ? value : std::string("default");
+            };
+            SPDLOG_INFO(
+                "Interrupts:\tMSI vectors: {} MSI-X vectors: {}",
+                overridden(fields::msiMultipleMessageCapable,
+                           std::to_string(1u << static_cast<uint32_t>(
+                                              config.msiMultipleMessageCapable))),
+                overridden(fields::msixTableSize,
+                           std::to_string(static_cast<uint32_t>(config.msixTableSize) + 1)));
+            SPDLOG_INFO("Latency:\tL0s acceptable: {} L1 acceptable: {} L0s exit: {} L1 exit: {}",
+                        overridden(fields::l0sAcceptableLatency,
+                                   valueName(gs_l0sAcceptableNames, config.l0sAcceptableLatency)),
+                        overridden(fields::l1AcceptableLatency,
+                                   valueName(gs_l1AcceptableNames, config.l1AcceptableLatency)),
+                        overridden(fields::l0sExitLatency,
+                                   valueName(gs_l0sExitNames, config.l0sExitLatency)),
+                        overridden(fields::l1ExitLatency,
+                                   valueName(gs_l1ExitNames, config.l1ExitLatency)));
+            // the exit time is unknown as long as one of the times is the hardware default
+            const bool l12Timing = view.enabled(fields::commonModeRestoreTime)
+                                   && (view.enabled(fields::tPowerOnValue)
+                                       || view.enabled(fields::tPowerOnScale));
+            SPDLOG_INFO("L1.2:\tT_POWER_ON: {} Common_Mode_Restore_Time: {} exit: {}",
+                        overridden(fields::tPowerOnValue,
+                                   std::to_string(tPowerOnMicroSeconds(config)) + "us"),
+                        overridden(fields::commonModeRestoreTime,
+                                   std::to_string(config.commonModeRestoreTime) + "us"),
+                        l12Timing ? std::to_string(l12ExitMicroSeconds(config)) + "us"
+                                  : std::string("default"));
+
             int ledID = 0;
             for (const auto& ledConfig : config.ledConfig)
             {
@@ -337,7 +1359,11 @@ int main(int argc, char const* argv[])
 
     try
     {
-        app.parse(argc, argv);
+        // CLI11 expects the arguments in reverse order
+        auto args = hoistConfigureOptions(*configCommand, { argv + 1, argv + argc });
+        std::reverse(args.begin(), args.end());
+        app.name(argv[0]);
+        app.parse(std::move(args));
     }
     catch (const CLI::ParseError& e)
     {
@@ -351,9 +1377,13 @@ int main(int argc, char const* argv[])
         SPDLOG_INFO("----- config.toml end -----");
     }
 
-    if (*configCommand)
+    if (*configCommand && !*batchCommand)
     {
-        if (*cInputOption && configParams.inputPath == configParams.outputPath)
+        if (*cPatchFlag)
+        {
+            SPDLOG_INFO("Patched EEPROM at: {}", configParams.outputPath);
+        }
+        else if (*cInputOption && configParams.inputPath == configParams.outputPath)
         {
             SPDLOG_INFO("Modified EEPROM at: {}", configParams.outputPath);
         }
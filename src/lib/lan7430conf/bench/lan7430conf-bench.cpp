@@ -0,0 +1,287 @@
+/** @file lan7430conf-bench.cpp
+ *
+ *  @brief benchmarks of the codec and I/O paths of the library, the results are written as JSON
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "version.hpp"
+
+#include <lan7430conf/batch.hpp>
+#include <lan7430conf/container.hpp>
+#include <lan7430conf/lan7430conf.hpp>
+
+#if __has_include(<cli11/CLI11.hpp>)
+#include <cli11/CLI11.hpp>
+#elif __has_include(<CLI/CLI.hpp>)
+#include <CLI/CLI.hpp>
+#endif
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkParameters
+{
+    std::string outputPath;
+    std::string directory;
+    std::string filter;
+    std::vector<uint64_t> batchSizes{ 10000, 100000, 1000000 };
+    double minSampleTime{ 0.1 };
+    unsigned int samples{ 5 };
+};
+
+struct MicroResult
+{
+    std::string name;
+    uint64_t iterations{ 0 };  // per sample
+    double median{ 0 };        // ns per call
+    double min{ 0 };
+    double max{ 0 };
+};
+
+struct MacroResult
+{
+    std::string name;
+    uint64_t images{ 0 };
+    double seconds{ 0 };
+};
+
+/// keeps the compiler from optimizing away the benchmarked call
+template<typename T>
+void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief calls \p f in a loop, the number of iterations is doubled until a sample takes at least
+ * \ref BenchmarkParameters::minSampleTime, then \ref BenchmarkParameters::samples are measured
+ */
+template<typename F>
+MicroResult measure(const BenchmarkParameters& params, const std::string& name, F&& f)
+{
+    const auto sample = [&](uint64_t iterations) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            doNotOptimize(f());
+        }
+        return secondsSince(start);
+    };
+
+    uint64_t iterations = 1;
+    while (sample(iterations) < params.minSampleTime && iterations < (uint64_t(1) << 40))
+    {
+        iterations *= 2;
+    }
+    std::vector<double> times;
+    for (unsigned int i = 0; i < std::max(1u, params.samples); ++i)
+    {
+        times.push_back(sample(iterations) * 1e9 / iterations);
+    }
+    std::sort(times.begin(), times.end());
+    return { name, iterations, times[times.size() / 2], times.front(), times.back() };
+}
+
+/// tmpfs, so the macro benchmarks measure the library and not the disk
+std::string defaultDirectory()
+{
+    if (std::filesystem::is_directory("/dev/shm"))
+    {
+        return "/dev/shm";
+    }
+    return std::filesystem::temp_directory_path().string();
+}
+
+std::string jsonString(const std::string& value)
+{
+    std::string quoted = "\"";
+    for (const char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void writeJson(std::ostream& out,
+               const std::vector<MicroResult>& micro,
+               const std::vector<MacroResult>& macro,
+               const std::string& directory)
+{
+    char timestamp[32]{};
+    const std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"version\": " << jsonString(std::string(lan743x::LAN743X_VERSION)) << ",\n";
+    out << "  \"timestamp\": " << jsonString(timestamp) << ",\n";
+    out << "  \"threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"directory\": " << jsonString(directory) << ",\n";
+    out << "  \"micro\": [";
+    for (size_t i = 0; i < micro.size(); ++i)
+    {
+        const MicroResult& result = micro[i];
+        out << (i == 0 ? "\n" : ",\n") << "    { \"name\": " << jsonString(result.name)
+            << ", \"iterations\": " << result.iterations << ", \"ns_median\": " << result.median
+            << ", \"ns_min\": " << result.min << ", \"ns_max\": " << result.max << " }";
+    }
+    out << "\n  ],\n";
+    out << "  \"macro\": [";
+    for (size_t i = 0; i < macro.size(); ++i)
+    {
+        const MacroResult& result = macro[i];
+        // nan and inf aren't valid JSON, an empty or too fast run has no rate
+        const double imagesPerSecond
+            = result.images != 0 && result.seconds > 0 ? result.images / result.seconds : 0;
+        out << (i == 0 ? "\n" : ",\n") << "    { \"name\": " << jsonString(result.name)
+            << ", \"images\": " << result.images << ", \"seconds\": " << result.seconds
+            << ", \"images_per_second\": " << imagesPerSecond << " }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    CLI::App app{ "Benchmarks of the lan7430conf codec and I/O paths, writes the results as JSON" };
+    BenchmarkParameters params;
+    params.directory = defaultDirectory();
+    app.add_option("-o,--output", params.outputPath, "Write the JSON results to this file");
+    app.add_option("-d,--directory",
+                   params.directory,
+                   "Directory the I/O benchmarks write to, should be on tmpfs")
+        ->capture_default_str()
+        ->check(CLI::ExistingDirectory);
+    app.add_option("-f,--filter", params.filter, "Only run benchmarks whose name contains this");
+    app.add_option("--batch-sizes", params.batchSizes, "Number of images of the macro benchmarks")
+        ->capture_default_str();
+    app.add_option("--samples", params.samples, "Samples per micro benchmark")
+        ->capture_default_str();
+    app.add_option("--min-sample-time",
+                   params.minSampleTime,
+                   "Minimum duration of a micro benchmark sample in seconds")
+        ->capture_default_str();
+    CLI11_PARSE(app, argc, argv);
+
+    const auto selected = [&](const std::string& name) {
+        return name.find(params.filter) != std::string::npos;
+    };
+
+    const std::filesystem::path workDirectory
+        = std::filesystem::path(params.directory)
+          / ("lan7430conf-bench-" + std::to_string(::getpid()));
+    std::vector<MicroResult> micro;
+    std::vector<MacroResult> macro;
+    try
+    {
+        std::filesystem::create_directory(workDirectory);
+
+        EEPROM_CONFIG config;
+        config.magic = EEPROM_MAGIC::EEPROM_MAC;
+        config.mac = stringToMac("00-02-01-23-10-55");
+        const EEPROM eeprom = createEEPROM(config);
+        const std::string imagePath = (workDirectory / "image.bin").string();
+        writeRawEEPROM(imagePath, eeprom);
+
+        const auto runMicro = [&](const std::string& name, auto&& f) {
+            if (selected(name))
+            {
+                std::cerr << name << std::endl;
+                micro.push_back(measure(params, name, f));
+            }
+        };
+        const std::string macString = macToString(config.mac);
+        EepromBytes bytes{};
+        std::memcpy(bytes.data(), &eeprom, sizeof(EEPROM));
+
+        runMicro("stringToMac", [&]() { return stringToMac(macString); });
+        runMicro("macToString", [&]() { return macToString(config.mac); });
+        runMicro("validateMAC", [&]() { return validateMAC(config.mac); });
+        runMicro("createEEPROM", [&]() { return createEEPROM(config); });
+        runMicro("eepromConfigToEEPROM", [&]() { return eepromConfigToEEPROM(eeprom); });
+        runMicro("validateEEPROM", [&]() { return validateEEPROM(bytes).value(); });
+        runMicro("readEEPROM", [&]() { return readEEPROM(imagePath); });
+        runMicro("writeEEPROM", [&]() {
+            writeEEPROM(imagePath, config);
+            return 0;
+        });
+
+        for (const uint64_t count : params.batchSizes)
+        {
+            const std::string batchName = "writeEEPROMBatch/" + std::to_string(count);
+            if (selected(batchName))
+            {
+                std::cerr << batchName << std::endl;
+                const std::filesystem::path batchDirectory = workDirectory / "batch";
+                std::filesystem::create_directory(batchDirectory);
+                const auto start = Clock::now();
+                writeEEPROMBatch(batchDirectory.string(), eeprom, config.mac, count);
+                macro.push_back({ batchName, count, secondsSince(start) });
+                std::filesystem::remove_all(batchDirectory);
+            }
+
+            const std::string containerName = "writeEEPROMContainer/" + std::to_string(count);
+            if (selected(containerName))
+            {
+                std::cerr << containerName << std::endl;
+                const std::string containerPath = (workDirectory / "images.l7c").string();
+                const auto start = Clock::now();
+                std::vector<EEPROM> images(count, eeprom);
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    images[i].mac = incrementMac(config.mac, i);
+                }
+                writeEEPROMContainer(containerPath, images);
+                macro.push_back({ containerName, count, secondsSince(start) });
+                std::filesystem::remove(containerPath);
+            }
+        }
+        std::filesystem::remove_all(workDirectory);
+    }
+    catch (const std::exception& e)
+    {
+        std::error_code ignored;
+        std::filesystem::remove_all(workDirectory, ignored);
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (params.outputPath.empty())
+    {
+        writeJson(std::cout, micro, macro, params.directory);
+        return EXIT_SUCCESS;
+    }
+    std::ofstream out(params.outputPath);
+    writeJson(out, micro, macro, params.directory);
+    if (!out)
+    {
+        std::cerr << "can't write " << params.outputPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+/** @file audit.hpp
+ *
+ *  @brief contains functions to check large amounts of EEPROM images for duplicate MAC addresses
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_AUDIT_HPP
+#define LAN7430_AUDIT_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct DuplicateMac
+{
+    Mac mac;
+    /// EEPROM files or "<file>[<index>]" for images within container and lot files
+    std::vector<std::string> locations;
+};
+
+struct MacAuditResult
+{
+    uint64_t files{ 0 };
+    uint64_t images{ 0 };
+    /// files that are neither EEPROM, container nor lot files or can't be read
+    std::vector<std::string> skipped;
+    /// sorted ascending by MAC address
+    std::vector<DuplicateMac> duplicates;
+};
+
+/**
+ * @brief scans EEPROM, container and lot files for MAC addresses that occur more than once
+ *
+ * Directories are searched recursively. The files are scanned in parallel, only the magic and the
+ * MAC address of EEPROM files are read. The MAC addresses are packed into 48 bit integers and
+ * radix sorted, so duplicates end up next to each other.
+ * @param paths files and directories
+ * @param threads number of worker threads, 0 uses std::thread::hardware_concurrency()
+ * @return MacAuditResult
+ */
+LAN7430_CONFIG_LIB_EXPORT MacAuditResult auditMacs(const std::vector<std::string>& paths,
+                                                   unsigned int threads = 0) noexcept(false);
+
+#endif  // LAN7430_AUDIT_HPP
@@ -0,0 +1,45 @@
+/** @file batch.hpp
+ *
+ *  @brief contains functions to create the EEPROM files for a whole range of MAC addresses
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_BATCH_HPP
+#define LAN7430_BATCH_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief returns the file name used for the EEPROM file of the given MAC address
+ * e.g. 00-02-01-23-10-58-pad.bin
+ * @param mac
+ * @return std::string
+ */
+LAN7430_CONFIG_LIB_EXPORT std::string batchFileName(const Mac& mac);
+
+/**
+ * @brief writes one EEPROM file per MAC address of the range [macStart, macStart + count) to the
+ * given directory, see \ref batchFileName
+ *
+ * The range is split into consecutive chunks, one per worker thread. Every worker patches the MAC
+ * address into its own copy of \p eeprom and opens/writes/closes its own files, the workers don't
+ * share any state except a flag to stop early if one of them fails.
+ * @param directory
+ * @param eeprom template, only the MAC address is replaced
+ * @param macStart
+ * @param count
+ * @param threads number of worker threads, 0 uses std::thread::hardware_concurrency()
+ */
+LAN7430_CONFIG_LIB_EXPORT void writeEEPROMBatch(const std::string& directory,
+                                                const EEPROM& eeprom,
+                                                const Mac& macStart,
+                                                uint64_t count,
+                                                unsigned int threads = 0) noexcept(false);
+
+#endif  // LAN7430_BATCH_HPP
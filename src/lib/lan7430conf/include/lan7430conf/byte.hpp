@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <type_traits>
 #include <utility>
 
 
@@ -93,4 +94,72 @@ constexpr void setBitmask(T& target, uint32_t start, uint32_t end, T value)
     target |= (value << start) & static_cast<T>(mask);
 }
 
+/**
+ * @brief mask of the bits [Start:End] of T
+ */
+template<typename T, uint32_t Start, uint32_t End = Start>
+constexpr T bitmask() noexcept
+{
+    static_assert(std::is_integral_v<T>, "bitmask requires an integral type");
+    static_assert(Start <= End, "start must be smaller or equal to end");
+    static_assert(End < sizeof(T) * 8, "end exceeds the bit width");
+
+    using U = std::make_unsigned_t<T>;
+    constexpr uint32_t width = sizeof(T) * 8;
+    return static_cast<T>(static_cast<U>(~U(0)) >> (width - 1 - (End - Start)) << Start);
+}
+
+/**
+ * @brief compile time variant of \ref getBitmask, reduces to one shift and mask
+ * @tparam T type the bits are returned as, e.g. a enum
+ * @tparam Start first bit
+ * @tparam End last bit
+ * @param source
+ */
+template<typename T, uint32_t Start, uint32_t End = Start, typename S>
+constexpr T getBits(S source) noexcept
+{
+    using U = std::make_unsigned_t<S>;
+    constexpr U mask = static_cast<U>(bitmask<S, Start, End>());
+    return static_cast<T>((static_cast<U>(source) & mask) >> Start);
+}
+
+/**
+ * @brief compile time variant of \ref setBitmask, reduces to one shift and mask
+ * unlike \ref setBitmask the bits are cleared before \p value is set, bits of \p value that
+ * exceed the range are ignored
+ * @tparam Start first bit
+ * @tparam End last bit
+ * @param target
+ * @param value integral, bool or enum
+ */
+template<uint32_t Start, uint32_t End = Start, typename T, typename V>
+constexpr void setBits(T& target, V value) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    constexpr U mask = static_cast<U>(bitmask<T, Start, End>());
+    const U bits = static_cast<U>(static_cast<U>(value) << Start);
+    target = static_cast<T>((static_cast<U>(target) & static_cast<U>(~mask)) | (bits & mask));
+}
+
+/**
+ * @brief swaps the bytes of a 16 bit word
+ */
+constexpr Byte16 swapBytes(Byte16 value) noexcept
+{
+    return static_cast<Byte16>((value << 8) | (value >> 8));
+}
+
+/**
+ * @brief constexpr replacement of htobe16 / be16toh, the conversion is its own inverse
+ */
+constexpr Byte16 bigEndian(Byte16 value) noexcept
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return swapBytes(value);
+#else
+    return value;
+#endif
+}
+
 #endif  // BYTE_HPP
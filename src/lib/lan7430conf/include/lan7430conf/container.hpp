@@ -0,0 +1,114 @@
+/** @file container.hpp
+ *
+ *  @brief contains a single file format holding many EEPROM images, indexed by MAC address
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_CONTAINER_HPP
+#define LAN7430_CONTAINER_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/mappedfile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Layout of a container file, all integers are little endian
+ *
+ * 0x00 - 0x3f  : header, see EEPROM_CONTAINER_HEADER
+ * indexOffset  : count * uint64, the MAC addresses as 48 bit integers sorted ascending
+ * imageOffset  : count * 512 bytes, the EEPROM images in the same order as the index
+ */
+static constexpr char eeprom_container_magic[8] = { 'L', '7', '4', '3', '0', 'I', 'M', 'G' };
+static constexpr uint32_t eeprom_container_version = 1;
+
+#pragma pack(push, 1)
+struct EEPROM_CONTAINER_HEADER
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t imageSize;
+    uint64_t count;
+    uint64_t indexOffset;
+    uint64_t imageOffset;
+    std::array<Byte, 24> reserved;
+};
+#pragma pack(pop)
+static_assert(sizeof(EEPROM_CONTAINER_HEADER) == 64, "container header must be 64 bytes");
+
+/**
+ * @brief read only view on a container file
+ *
+ * The file is mapped into memory, the returned EEPROMs point directly into the mapping and are
+ * valid as long as the container exists.
+ */
+class LAN7430_CONFIG_LIB_EXPORT EepromContainer
+{
+public:
+    explicit EepromContainer(const std::string& filePath) noexcept(false);
+
+    /**
+     * @brief checks whether the file at the given path starts with the container magic
+     * @param filePath
+     * @return bool
+     */
+    static bool isContainer(const std::string& filePath) noexcept;
+
+    uint64_t size() const noexcept { return m_count; }
+    /**
+     * @brief returns the MAC address of the image at the given index (sorted ascending)
+     * @param index
+     * @return Mac
+     */
+    Mac macAt(uint64_t index) const noexcept;
+    /**
+     * @brief returns the image at the given index (sorted ascending by MAC address)
+     * @param index
+     * @return const EEPROM&
+     */
+    const EEPROM& imageAt(uint64_t index) const noexcept;
+    /**
+     * @brief binary search for the image of the given MAC address
+     * @param mac
+     * @return the image or nullptr if the container has no image for \p mac
+     */
+    const EEPROM* find(const Mac& mac) const noexcept;
+    /**
+     * @brief same as \ref find, but throws if the MAC address is not found
+     * @param mac
+     * @return const EEPROM&
+     */
+    const EEPROM& at(const Mac& mac) const noexcept(false);
+
+private:
+    uint64_t keyAt(uint64_t index) const noexcept;
+
+    MappedFile m_file;
+    uint64_t m_count{ 0 };
+    const Byte* m_index{ nullptr };
+    const Byte* m_images{ nullptr };
+};
+
+/**
+ * @brief writes all images into a single container file
+ * The images are sorted by their MAC address, every MAC address must be unique.
+ * @param filePath
+ * @param images
+ */
+LAN7430_CONFIG_LIB_EXPORT void writeEEPROMContainer(
+    const std::string& filePath, const std::vector<EEPROM>& images) noexcept(false);
+
+/**
+ * @brief reads the image of the given MAC address from a container file and validates it
+ * @param containerPath
+ * @param mac
+ * @return EEPROM
+ */
+LAN7430_CONFIG_LIB_EXPORT EEPROM readEEPROM(const std::string& containerPath,
+                                            const Mac& mac) noexcept(false);
+
+#endif  // LAN7430_CONTAINER_HPP
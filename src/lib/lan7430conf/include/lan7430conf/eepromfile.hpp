@@ -0,0 +1,70 @@
+/** @file eepromfile.hpp
+ *
+ *  @brief contains a zero copy reader for EEPROM files
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_EEPROMFILE_HPP
+#define LAN7430_EEPROMFILE_HPP
+
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/mappedfile.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/**
+ * @brief maps a EEPROM file read only and validates it without copying
+ *
+ * The file is opened, fstat'ed and mapped once. Files of 255 bytes (as created by MPLAB Connect)
+ * are accepted as well, the bytes behind the end of such a file read as 0, as the mapping covers a
+ * whole page.
+ */
+class LAN7430_CONFIG_LIB_EXPORT EepromFile
+{
+public:
+    /**
+     * @brief maps and validates the file
+     * throws FILE_PATH_DOESNT_EXIST, FILE_CANT_READ, EEPROM_WRONG_SIZE or the errors of
+     * \ref validateEEPROM
+     * @param filePath
+     */
+    explicit EepromFile(const std::string& filePath) noexcept(false);
+
+    /**
+     * @brief the EEPROM within the mapping, valid as long as the EepromFile exists
+     */
+    const EEPROM& eeprom() const noexcept
+    {
+        return *reinterpret_cast<const EEPROM*>(m_file.data());
+    }
+    /**
+     * @brief size of the file, 255 or 512
+     */
+    size_t size() const noexcept { return m_file.size(); }
+
+private:
+    MappedFile m_file;
+};
+
+/**
+ * @brief modifies an existing EEPROM file in place
+ *
+ * The file is read with a single pread, \p edit modifies it through a EepromRef and only the byte
+ * range that actually changed is written back with a single pwrite. Bits this library doesn't know
+ * about (e.g. set by MPLAB Connect) are preserved, the size of the file (255 or 512) is kept.
+ * The edited EEPROM is validated before anything is written.
+ * @param filePath
+ * @param edit
+ * @return size_t number of bytes written, 0 if nothing changed
+ */
+LAN7430_CONFIG_LIB_EXPORT size_t patchEEPROM(const std::string& filePath,
+                                             const std::function<void(EepromRef&)>& edit) noexcept(
+    false);
+
+#endif  // LAN7430_EEPROMFILE_HPP
@@ -0,0 +1,108 @@
+/** @file eepromview.hpp
+ *
+ *  @brief contains views that decode / encode single fields of a EEPROM on demand
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_EEPROMVIEW_HPP
+#define LAN7430_EEPROMVIEW_HPP
+
+#include "lan7430conf/fields.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+
+/**
+ * @brief read only view over the bytes of a EEPROM, e.g. a EepromFile or an image of a container
+ *
+ * Unlike \ref eepromConfigToEEPROM only the requested field is decoded:
+ * EepromView(eeprom).get(fields::led2Control)
+ * The view doesn't own the bytes.
+ */
+class EepromView
+{
+public:
+    constexpr EepromView(const EEPROM& eeprom) noexcept
+    : m_eeprom(&eeprom)
+    {
+    }
+    EepromView(const EepromBytes& bytes) noexcept
+    : m_eeprom(reinterpret_cast<const EEPROM*>(bytes.data()))
+    {
+    }
+
+    constexpr EEPROM_MAGIC magic() const noexcept { return get(fields::magic); }
+    constexpr const Mac& mac() const noexcept { return m_eeprom->mac; }
+
+    /**
+     * @brief decodes a single field, see fields.hpp
+     */
+    template<typename F>
+    constexpr typename F::value_type get(const F& field) const noexcept
+    {
+        return decodeValue(field, *m_eeprom);
+    }
+    /**
+     * @brief returns whether the enable bit of the field is set
+     */
+    template<typename F>
+    constexpr bool enabled(const F& field) const noexcept
+    {
+        return isEnabled(field, *m_eeprom);
+    }
+
+    constexpr const EEPROM& eeprom() const noexcept { return *m_eeprom; }
+
+private:
+    const EEPROM* m_eeprom;
+};
+
+/**
+ * @brief mutable view over the bytes of a EEPROM
+ *
+ * set() only touches the bits of the field and its enable bit, all other bits, including the ones
+ * this library doesn't know about, keep their value.
+ */
+class EepromRef : public EepromView
+{
+public:
+    constexpr EepromRef(EEPROM& eeprom) noexcept
+    : EepromView(eeprom)
+    , m_eeprom(&eeprom)
+    {
+    }
+    EepromRef(EepromBytes& bytes) noexcept
+    : EepromView(bytes)
+    , m_eeprom(reinterpret_cast<EEPROM*>(bytes.data()))
+    {
+    }
+
+    constexpr void setMagic(EEPROM_MAGIC magic) noexcept { set(fields::magic, magic); }
+    constexpr void setMac(const Mac& mac) noexcept { m_eeprom->mac = mac; }
+
+    /**
+     * @brief encodes a single field, see fields.hpp
+     */
+    template<typename F>
+    constexpr void set(const F& field, typename F::value_type value) noexcept
+    {
+        encodeValue(field, value, *m_eeprom);
+    }
+    /**
+     * @brief encodes a single field and sets its enable bit even if \p value is 0, see
+     * \ref overrideValue
+     */
+    template<typename F>
+    constexpr void force(const F& field, typename F::value_type value) noexcept
+    {
+        overrideValue(field, value, *m_eeprom);
+    }
+
+    using EepromView::eeprom;
+    constexpr EEPROM& eeprom() noexcept { return *m_eeprom; }
+
+private:
+    EEPROM* m_eeprom;
+};
+
+#endif  // LAN7430_EEPROMVIEW_HPP
@@ -11,6 +11,7 @@
 #define LAN7430_ERRORS_HPP
 
 #include <exception>
+#include <system_error>
 
 #include "lan7430conf/lan7430-config-lib_export.h"
 
@@ -19,6 +20,7 @@ constexpr int IFM_NO_ERROR = 0;
 
 constexpr int MAC_ADDRESS_EMPTY = 1000;
 constexpr int MAC_ADDRESS_INVALID = 1001;
+constexpr int MAC_ADDRESS_OVERFLOW = 1002;
 
 constexpr int FOLDER_PATH_DOESNT_EXIST = 2000;
 constexpr int FILE_PATH_DOESNT_EXIST = 2001;
@@ -27,6 +29,28 @@ constexpr int FILE_CANT_WRITE = 2003;
 
 constexpr int EEPROM_WRONG_SIZE = 3000;
 constexpr int EEPROM_INVALID_MAGIC = 3001;
+constexpr int EEPROM_VALUE_OUT_OF_RANGE = 3002;
+
+constexpr int CONTAINER_INVALID = 4000;
+constexpr int CONTAINER_MAC_NOT_FOUND = 4001;
+constexpr int CONTAINER_DUPLICATE_MAC = 4002;
+constexpr int LOT_INVALID = 4003;
+constexpr int LOT_IMAGE_MISMATCH = 4004;
+constexpr int LOT_IMAGE_NOT_FOUND = 4005;
+
+constexpr int LEDGER_INVALID = 5000;
+constexpr int LEDGER_INVALID_RANGE = 5001;
+constexpr int LEDGER_EXHAUSTED = 5002;
+
+constexpr int SERVER_SOCKET_ERROR = 6000;
+constexpr int SERVER_INVALID_REQUEST = 6001;
+constexpr int SERVER_NO_TEMPLATE = 6002;
+
+constexpr int STREAM_INVALID_RECORD = 7000;
+constexpr int STREAM_UNKNOWN_MEMBER = 7001;
+constexpr int STREAM_INVALID_VALUE = 7002;
+
+constexpr int PROFILE_UNKNOWN = 8000;
 
 class LAN7430_CONFIG_LIB_EXPORT error_type : public std::exception
 {
@@ -43,6 +67,19 @@ private:
     error_type() = delete;
     int m_errnum;
 };
+
+/**
+ * @brief the category of the error codes above, the messages are the same as error_type::what()
+ */
+LAN7430_CONFIG_LIB_EXPORT const std::error_category& error_category() noexcept;
+
+/**
+ * @brief wraps one of the error codes above into a std::error_code
+ */
+inline std::error_code make_error_code(int errnum) noexcept
+{
+    return { errnum, error_category() };
+}
 }  // namespace ifm
 
 #endif // LAN7430_ERRORS_HPP
@@ -0,0 +1,435 @@
+/** @file fields.hpp
+ *
+ *  @brief contains the descriptor table that maps the members of EEPROM_CONFIG to the bits of the
+ *  EEPROM
+ *
+ *  Every field is described once by the EEPROM register it lives in, its bit range, the bit of the
+ *  override word (0x07 - 0x0a) that enables it and the EEPROM_CONFIG member it is decoded to.
+ *  createEEPROM and eepromConfigToEEPROM are loops over \ref eeprom_fields, so both directions
+ *  always agree. Adding a field means adding one descriptor to the table.
+ *
+ *  Everything in here is constexpr, so images can be created at compile time:
+ *  constexpr EEPROM eeprom = createEEPROMConstexpr(config);
+ *  The header is included by lan7430conf.hpp.
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_FIELDS_HPP
+#define LAN7430_FIELDS_HPP
+
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief byte order of a register within the EEPROM
+ */
+enum class WORD_ORDER
+{
+    HOST,
+    BIG,
+};
+
+/// fields without an enable bit are always loaded by the LAN7430
+static constexpr uint32_t no_enable_bit = 32;
+
+/**
+ * @brief the bytes of the override word, bit n is located in bit n % 8 of byte 0x07 + n / 8
+ */
+static constexpr Byte EEPROM::*eeprom_enable_word[] = {
+    &EEPROM::byte7,
+    &EEPROM::deviceCapabilitiesEnable_1_2,
+    &EEPROM::l1PMSubstatesCapabilitesEnable,
+    &EEPROM::aspmConfigEnable,
+};
+
+/**
+ * @brief describes where a member of EEPROM_CONFIG is stored in the EEPROM
+ * @tparam Register EEPROM member the field is stored in
+ * @tparam Start first bit of the field within the register
+ * @tparam End last bit of the field within the register
+ * @tparam EnableBit bit of the override word which is set if the field is not 0, or no_enable_bit
+ * @tparam Order byte order of the register
+ * @tparam Accessor callable returning a reference to the EEPROM_CONFIG member
+ */
+template<auto Register,
+         uint32_t Start,
+         uint32_t End,
+         uint32_t EnableBit,
+         WORD_ORDER Order,
+         typename Accessor>
+struct Field
+{
+    using register_type = std::remove_reference_t<decltype(std::declval<EEPROM&>().*Register)>;
+    using value_type = std::decay_t<decltype(std::declval<Accessor>()(
+        std::declval<EEPROM_CONFIG&>()))>;
+
+    static_assert(std::is_unsigned_v<register_type>, "registers are Byte or Byte16");
+    static_assert(Start <= End && End < sizeof(register_type) * 8, "bits exceed the register");
+    static_assert(EnableBit <= no_enable_bit, "the override word has 32 bits");
+
+    static constexpr auto reg = Register;
+    static constexpr uint32_t start = Start;
+    static constexpr uint32_t end = End;
+    static constexpr uint32_t enableBit = EnableBit;
+    static constexpr WORD_ORDER order = Order;
+    static constexpr register_type mask = bitmask<register_type, Start, End>();
+
+    /// name of the EEPROM_CONFIG member, e.g. "ledConfig[0].control"
+    const char* name;
+    Accessor member;
+};
+
+/**
+ * @brief creates a Field, the accessor type is deduced
+ */
+template<auto Register,
+         uint32_t Start,
+         uint32_t End,
+         uint32_t EnableBit = no_enable_bit,
+         WORD_ORDER Order = WORD_ORDER::HOST,
+         typename Accessor>
+constexpr Field<Register, Start, End, EnableBit, Order, Accessor> field(const char* name,
+                                                                        Accessor accessor)
+{
+    return { name, accessor };
+}
+
+/**
+ * @brief reads the register of the field in host byte order
+ */
+template<typename F>
+constexpr typename F::register_type readRegister(const F&, const EEPROM& eeprom) noexcept
+{
+    typename F::register_type value = eeprom.*F::reg;
+    if constexpr (F::order == WORD_ORDER::BIG)
+    {
+        value = bigEndian(value);
+    }
+    return value;
+}
+
+/**
+ * @brief writes the register of the field given in host byte order
+ */
+template<typename F>
+constexpr void writeRegister(const F&, EEPROM& eeprom, typename F::register_type value) noexcept
+{
+    if constexpr (F::order == WORD_ORDER::BIG)
+    {
+        value = bigEndian(value);
+    }
+    eeprom.*F::reg = value;
+}
+
+/**
+ * @brief stores \p value in the bits of the field, only the bits of the field and its enable bit
+ * are touched
+ */
+template<typename F>
+constexpr void encodeValue(const F& field, typename F::value_type value, EEPROM& eeprom) noexcept
+{
+    const auto raw = static_cast<typename F::register_type>(value);
+
+    auto word = readRegister(field, eeprom);
+    setBits<F::start, F::end>(word, raw);
+    writeRegister(field, eeprom, word);
+
+    if constexpr (F::enableBit != no_enable_bit)
+    {
+        setBits<F::enableBit % 8>(eeprom.*eeprom_enable_word[F::enableBit / 8], raw != 0);
+    }
+}
+
+/**
+ * @brief stores \p value like \ref encodeValue, but sets the enable bit even if \p value is 0
+ *
+ * A cleared enable bit makes the LAN7430 keep its hardware default, so a feature is only forced
+ * off by loading a 0 with the enable bit set.
+ */
+template<typename F>
+constexpr void overrideValue(const F& field, typename F::value_type value, EEPROM& eeprom) noexcept
+{
+    encodeValue(field, value, eeprom);
+    if constexpr (F::enableBit != no_enable_bit)
+    {
+        setBits<F::enableBit % 8>(eeprom.*eeprom_enable_word[F::enableBit / 8], true);
+    }
+}
+
+/**
+ * @brief loads the value of the field from \p eeprom
+ */
+template<typename F>
+constexpr typename F::value_type decodeValue(const F& field, const EEPROM& eeprom) noexcept
+{
+    return getBits<typename F::value_type, F::start, F::end>(readRegister(field, eeprom));
+}
+
+/**
+ * @brief returns whether the enable bit of the field is set, fields without one are always enabled
+ */
+template<typename F>
+constexpr bool isEnabled(const F&, const EEPROM& eeprom) noexcept
+{
+    if constexpr (F::enableBit != no_enable_bit)
+    {
+        return getBits<bool, F::enableBit % 8>(eeprom.*eeprom_enable_word[F::enableBit / 8]);
+    }
+    return true;
+}
+
+/**
+ * @brief stores the value of the field in \p config to \p eeprom, see \ref encodeValue
+ */
+template<typename F>
+constexpr void encodeField(const F& field, const EEPROM_CONFIG& config, EEPROM& eeprom) noexcept
+{
+    encodeValue(field, field.member(config), eeprom);
+}
+
+/**
+ * @brief loads the value of the field from \p eeprom into \p config
+ */
+template<typename F>
+constexpr void decodeField(const F& field, const EEPROM& eeprom, EEPROM_CONFIG& config) noexcept
+{
+    field.member(config) = decodeValue(field, eeprom);
+}
+
+/* clang-format off */
+namespace fields {
+static constexpr auto magic = field<&EEPROM::magic, 0, 7>(
+    "magic", [](auto& c) -> auto& { return c.magic; });
+
+static constexpr auto subsystemVendorID = field<&EEPROM::subsystemVendorID, 0, 15, 0>(
+    "subsystemVendorID", [](auto& c) -> auto& { return c.subsystemVendorID; });
+static constexpr auto subsystemID = field<&EEPROM::subsystemID, 0, 15, 1>(
+    "subsystemID", [](auto& c) -> auto& { return c.subsystemID; });
+
+static constexpr auto auxCurrent = field<&EEPROM::powerManagementCapabilities, 0, 2, 2>(
+    "auxCurrent", [](auto& c) -> auto& { return c.auxCurrent; });
+static constexpr auto pmeSupport = field<&EEPROM::powerManagementCapabilities, 3, 7, 3>(
+    "pmeSupport", [](auto& c) -> auto& { return c.pmeSupport; });
+
+static constexpr auto msiMultipleMessageCapable = field<&EEPROM::msiCapabilities, 4, 6, 6>(
+    "msiMultipleMessageCapable", [](auto& c) -> auto& { return c.msiMultipleMessageCapable; });
+
+static constexpr auto l0sAcceptableLatency = field<&EEPROM::endpointAcceptableLatency, 0, 2, 7>(
+    "l0sAcceptableLatency", [](auto& c) -> auto& { return c.l0sAcceptableLatency; });
+static constexpr auto l1AcceptableLatency = field<&EEPROM::endpointAcceptableLatency, 4, 6, 8>(
+    "l1AcceptableLatency", [](auto& c) -> auto& { return c.l1AcceptableLatency; });
+
+static constexpr auto l0sExitLatency = field<&EEPROM::deviceCapabilities_1, 0, 2, 9>(
+    "l0sExitLatency", [](auto& c) -> auto& { return c.l0sExitLatency; });
+static constexpr auto l1ExitLatency = field<&EEPROM::deviceCapabilities_1, 4, 6, 10>(
+    "l1ExitLatency", [](auto& c) -> auto& { return c.l1ExitLatency; });
+static constexpr auto clockPowerManagement = field<&EEPROM::deviceCapabilities_1, 7, 7, 11>(
+    "clockPowerManagement", [](auto& c) -> auto& { return c.clockPowerManagement; });
+
+static constexpr auto ltrMechanismSupport = field<&EEPROM::deviceCapabilities_2, 1, 1, 15>(
+    "ltrMechanismSupport", [](auto& c) -> auto& { return c.ltrMechanismSupport; });
+static constexpr auto obffSupport = field<&EEPROM::deviceCapabilities_2, 2, 3, 16>(
+    "obffSupport", [](auto& c) -> auto& { return c.obffSupport; });
+static constexpr auto msixTableSize = field<&EEPROM::deviceCapabilities_2, 4, 6, 17>(
+    "msixTableSize", [](auto& c) -> auto& { return c.msixTableSize; });
+
+static constexpr auto pciPML12Support = field<&EEPROM::l1PMSubstatesCapabilites, 0, 0, 18>(
+    "pciPML12Support", [](auto& c) -> auto& { return c.pciPML12Support; });
+static constexpr auto pciPML11Support = field<&EEPROM::l1PMSubstatesCapabilites, 1, 1, 19>(
+    "pciPML11Support", [](auto& c) -> auto& { return c.pciPML11Support; });
+static constexpr auto aspmL12Support = field<&EEPROM::l1PMSubstatesCapabilites, 2, 2, 20>(
+    "aspmL12Support", [](auto& c) -> auto& { return c.aspmL12Support; });
+static constexpr auto aspmL11Support = field<&EEPROM::l1PMSubstatesCapabilites, 3, 3, 21>(
+    "aspmL11Support", [](auto& c) -> auto& { return c.aspmL11Support; });
+static constexpr auto l1PMSubstatesSupported = field<&EEPROM::l1PMSubstatesCapabilites, 4, 4, 22>(
+    "l1PMSubstatesSupported", [](auto& c) -> auto& { return c.l1PMSubstatesSupported; });
+
+static constexpr auto commonModeRestoreTime = field<&EEPROM::portCommonModeRestoreTime, 0, 7, 23>(
+    "commonModeRestoreTime", [](auto& c) -> auto& { return c.commonModeRestoreTime; });
+static constexpr auto tPowerOnValue = field<&EEPROM::portTPowerOn, 0, 4, 24>(
+    "tPowerOnValue", [](auto& c) -> auto& { return c.tPowerOnValue; });
+static constexpr auto tPowerOnScale = field<&EEPROM::portTPowerOn, 6, 7, 25>(
+    "tPowerOnScale", [](auto& c) -> auto& { return c.tPowerOnScale; });
+
+static constexpr auto aspmL0EntranceLatency = field<&EEPROM::aspmConfig, 0, 2, 26>(
+    "aspmL0EntranceLatency", [](auto& c) -> auto& { return c.aspmL0EntranceLatency; });
+static constexpr auto aspmL1EntranceLatency = field<&EEPROM::aspmConfig, 4, 6, 27>(
+    "aspmL1EntranceLatency", [](auto& c) -> auto& { return c.aspmL1EntranceLatency; });
+static constexpr auto aspmL1EntryControl = field<&EEPROM::aspmConfig, 7, 7, 28>(
+    "aspmL1EntryControl", [](auto& c) -> auto& { return c.aspmL1EntryControl; });
+
+static constexpr auto macConfiguration = field<&EEPROM::macConfig1, 0, 1>(
+    "macConfiguration", [](auto& c) -> auto& { return c.macConfiguration; });
+static constexpr auto duplexMode = field<&EEPROM::macConfig1, 2, 2>(
+    "duplexMode", [](auto& c) -> auto& { return c.duplexMode; });
+static constexpr auto automaticSpeedDetection = field<&EEPROM::macConfig1, 3, 3>(
+    "automaticSpeedDetection", [](auto& c) -> auto& { return c.automaticSpeedDetection; });
+static constexpr auto automaticDuplexDetection = field<&EEPROM::macConfig1, 4, 4>(
+    "automaticDuplexDetection", [](auto& c) -> auto& { return c.automaticDuplexDetection; });
+static constexpr auto automaticDuplexPolarity = field<&EEPROM::macConfig1, 5, 5>(
+    "automaticDuplexPolarity", [](auto& c) -> auto& { return c.automaticDuplexPolarity; });
+static constexpr auto energyEfficientEthernet = field<&EEPROM::macConfig1, 7, 7>(
+    "energyEfficientEthernet", [](auto& c) -> auto& { return c.energyEfficientEthernet; });
+static constexpr auto energyEfficientEthernetTxClockStop = field<&EEPROM::macConfig2, 0, 0>(
+    "energyEfficientEthernetTxClockStop",
+    [](auto& c) -> auto& { return c.energyEfficientEthernetTxClockStop; });
+
+static constexpr auto led0Enable = field<&EEPROM::ledConfig1, 0, 0>(
+    "ledConfig[0].enable", [](auto& c) -> auto& { return c.ledConfig[0].enable; });
+static constexpr auto led1Enable = field<&EEPROM::ledConfig1, 1, 1>(
+    "ledConfig[1].enable", [](auto& c) -> auto& { return c.ledConfig[1].enable; });
+static constexpr auto led2Enable = field<&EEPROM::ledConfig1, 2, 2>(
+    "ledConfig[2].enable", [](auto& c) -> auto& { return c.ledConfig[2].enable; });
+static constexpr auto led3Enable = field<&EEPROM::ledConfig1, 3, 3>(
+    "ledConfig[3].enable", [](auto& c) -> auto& { return c.ledConfig[3].enable; });
+static constexpr auto led0Polarity = field<&EEPROM::ledConfig1, 4, 4>(
+    "ledConfig[0].polarity", [](auto& c) -> auto& { return c.ledConfig[0].polarity; });
+static constexpr auto led1Polarity = field<&EEPROM::ledConfig1, 5, 5>(
+    "ledConfig[1].polarity", [](auto& c) -> auto& { return c.ledConfig[1].polarity; });
+static constexpr auto led2Polarity = field<&EEPROM::ledConfig1, 6, 6>(
+    "ledConfig[2].polarity", [](auto& c) -> auto& { return c.ledConfig[2].polarity; });
+static constexpr auto led3Polarity = field<&EEPROM::ledConfig1, 7, 7>(
+    "ledConfig[3].polarity", [](auto& c) -> auto& { return c.ledConfig[3].polarity; });
+
+static constexpr auto led0Control
+    = field<&EEPROM::ledConfig2, 0, 3, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[0].control", [](auto& c) -> auto& { return c.ledConfig[0].control; });
+static constexpr auto led1Control
+    = field<&EEPROM::ledConfig2, 4, 7, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[1].control", [](auto& c) -> auto& { return c.ledConfig[1].control; });
+static constexpr auto led2Control
+    = field<&EEPROM::ledConfig2, 8, 11, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[2].control", [](auto& c) -> auto& { return c.ledConfig[2].control; });
+static constexpr auto led3Control
+    = field<&EEPROM::ledConfig2, 12, 15, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[3].control", [](auto& c) -> auto& { return c.ledConfig[3].control; });
+
+static constexpr auto led0Combine
+    = field<&EEPROM::ledConfig3, 0, 0, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[0].combineFeature",
+        [](auto& c) -> auto& { return c.ledConfig[0].combineFeature; });
+static constexpr auto led1Combine
+    = field<&EEPROM::ledConfig3, 1, 1, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[1].combineFeature",
+        [](auto& c) -> auto& { return c.ledConfig[1].combineFeature; });
+static constexpr auto led2Combine
+    = field<&EEPROM::ledConfig3, 2, 2, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[2].combineFeature",
+        [](auto& c) -> auto& { return c.ledConfig[2].combineFeature; });
+static constexpr auto led3Combine
+    = field<&EEPROM::ledConfig3, 3, 3, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[3].combineFeature",
+        [](auto& c) -> auto& { return c.ledConfig[3].combineFeature; });
+static constexpr auto led0BlinkPulseStretch
+    = field<&EEPROM::ledConfig3, 5, 5, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[0].blinkPulseStretch",
+        [](auto& c) -> auto& { return c.ledConfig[0].blinkPulseStretch; });
+static constexpr auto led1BlinkPulseStretch
+    = field<&EEPROM::ledConfig3, 6, 6, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[1].blinkPulseStretch",
+        [](auto& c) -> auto& { return c.ledConfig[1].blinkPulseStretch; });
+static constexpr auto led2BlinkPulseStretch
+    = field<&EEPROM::ledConfig3, 7, 7, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[2].blinkPulseStretch",
+        [](auto& c) -> auto& { return c.ledConfig[2].blinkPulseStretch; });
+static constexpr auto led3BlinkPulseStretch
+    = field<&EEPROM::ledConfig3, 8, 8, no_enable_bit, WORD_ORDER::BIG>(
+        "ledConfig[3].blinkPulseStretch",
+        [](auto& c) -> auto& { return c.ledConfig[3].blinkPulseStretch; });
+static constexpr auto blinkPulseStretchRate
+    = field<&EEPROM::ledConfig3, 10, 11, no_enable_bit, WORD_ORDER::BIG>(
+        "blinkPulseStretchRate", [](auto& c) -> auto& { return c.blinkPulseStretchRate; });
+static constexpr auto ledPulsing
+    = field<&EEPROM::ledConfig3, 12, 12, no_enable_bit, WORD_ORDER::BIG>(
+        "ledPulsing", [](auto& c) -> auto& { return c.ledPulsing; });
+static constexpr auto ledActivityOutput
+    = field<&EEPROM::ledConfig3, 14, 14, no_enable_bit, WORD_ORDER::BIG>(
+        "ledActivityOutput", [](auto& c) -> auto& { return c.ledActivityOutput; });
+}  // namespace fields
+
+/**
+ * @brief all fields of EEPROM_CONFIG except the MAC address, which is copied as a whole
+ */
+static constexpr auto eeprom_fields = std::make_tuple(
+    fields::magic,
+    fields::subsystemVendorID, fields::subsystemID,
+    fields::auxCurrent, fields::pmeSupport,
+    fields::msiMultipleMessageCapable,
+    fields::l0sAcceptableLatency, fields::l1AcceptableLatency,
+    fields::l0sExitLatency, fields::l1ExitLatency, fields::clockPowerManagement,
+    fields::ltrMechanismSupport, fields::obffSupport, fields::msixTableSize,
+    fields::pciPML12Support, fields::pciPML11Support,
+    fields::aspmL12Support, fields::aspmL11Support, fields::l1PMSubstatesSupported,
+    fields::commonModeRestoreTime, fields::tPowerOnValue, fields::tPowerOnScale,
+    fields::aspmL0EntranceLatency, fields::aspmL1EntranceLatency, fields::aspmL1EntryControl,
+    fields::macConfiguration, fields::duplexMode,
+    fields::automaticSpeedDetection, fields::automaticDuplexDetection,
+    fields::automaticDuplexPolarity,
+    fields::energyEfficientEthernet, fields::energyEfficientEthernetTxClockStop,
+    fields::led0Enable, fields::led1Enable, fields::led2Enable, fields::led3Enable,
+    fields::led0Polarity, fields::led1Polarity, fields::led2Polarity, fields::led3Polarity,
+    fields::led0Control, fields::led1Control, fields::led2Control, fields::led3Control,
+    fields::led0Combine, fields::led1Combine, fields::led2Combine, fields::led3Combine,
+    fields::led0BlinkPulseStretch, fields::led1BlinkPulseStretch,
+    fields::led2BlinkPulseStretch, fields::led3BlinkPulseStretch,
+    fields::blinkPulseStretchRate, fields::ledPulsing, fields::ledActivityOutput);
+/* clang-format on */
+
+/**
+ * @brief calls \p function for every descriptor of \ref eeprom_fields
+ */
+template<typename Function>
+constexpr void forEachField(Function&& function)
+{
+    std::apply([&](const auto&... field) { (function(field), ...); }, eeprom_fields);
+}
+
+/**
+ * @brief encodes all fields of \ref eeprom_fields, see \ref encodeField
+ */
+constexpr void encodeFields(const EEPROM_CONFIG& config, EEPROM& eeprom) noexcept
+{
+    forEachField([&](const auto& field) { encodeField(field, config, eeprom); });
+}
+
+/**
+ * @brief decodes all fields of \ref eeprom_fields, see \ref decodeField
+ */
+constexpr void decodeFields(const EEPROM& eeprom, EEPROM_CONFIG& config) noexcept
+{
+    forEachField([&](const auto& field) { decodeField(field, eeprom, config); });
+}
+
+constexpr EEPROM_CONFIG eepromConfigToEEPROMConstexpr(const EEPROM& eeprom) noexcept
+{
+    EEPROM_CONFIG config{};
+
+    decodeFields(eeprom, config);
+    config.mac = eeprom.mac;
+
+    return config;
+}
+
+constexpr EEPROM createEEPROMConstexpr(const EEPROM_CONFIG& conf) noexcept
+{
+    EEPROM eeprom{};
+
+    encodeFields(conf, eeprom);
+    eeprom.mac = conf.mac;
+
+    // copy the remaining base eeprom to the array, std::copy isn't constexpr before C++20
+    for (size_t i = 0; i < eeprom.base_config.size(); ++i)
+    {
+        eeprom.base_config[i] = base_eeprom[eeprom_user_defined_size + i];
+    }
+
+    return eeprom;
+}
+
+#endif  // LAN7430_FIELDS_HPP
@@ -16,6 +16,9 @@
 
 #include <array>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 enum class EEPROM_MAGIC
 {
@@ -82,6 +85,105 @@ enum class ASPM_L1_ENTRANCE_LATENCY
     MICRO_SECONDS_64 = 0x6,
 };
 
+/**
+ * @brief largest L0s exit latency of the link the endpoint tolerates
+ */
+enum class L0S_ACCEPTABLE_LATENCY
+{
+    NANO_SECONDS_64 = 0x0,
+    NANO_SECONDS_128 = 0x1,
+    NANO_SECONDS_256 = 0x2,
+    NANO_SECONDS_512 = 0x3,
+    MICRO_SECONDS_1 = 0x4,
+    MICRO_SECONDS_2 = 0x5,
+    MICRO_SECONDS_4 = 0x6,
+    NO_LIMIT = 0x7,
+};
+
+/**
+ * @brief largest L1 exit latency of the link the endpoint tolerates
+ */
+enum class L1_ACCEPTABLE_LATENCY
+{
+    MICRO_SECONDS_1 = 0x0,
+    MICRO_SECONDS_2 = 0x1,
+    MICRO_SECONDS_4 = 0x2,
+    MICRO_SECONDS_8 = 0x3,
+    MICRO_SECONDS_16 = 0x4,
+    MICRO_SECONDS_32 = 0x5,
+    MICRO_SECONDS_64 = 0x6,
+    NO_LIMIT = 0x7,
+};
+
+/**
+ * @brief time the port needs to leave L0s, the value names the upper bound of the range
+ */
+enum class L0S_EXIT_LATENCY
+{
+    BELOW_NANO_SECONDS_64 = 0x0,
+    BELOW_NANO_SECONDS_128 = 0x1,
+    BELOW_NANO_SECONDS_256 = 0x2,
+    BELOW_NANO_SECONDS_512 = 0x3,
+    BELOW_MICRO_SECONDS_1 = 0x4,
+    BELOW_MICRO_SECONDS_2 = 0x5,
+    UP_TO_MICRO_SECONDS_4 = 0x6,
+    ABOVE_MICRO_SECONDS_4 = 0x7,
+};
+
+/**
+ * @brief time the port needs to leave L1, the value names the upper bound of the range
+ */
+enum class L1_EXIT_LATENCY
+{
+    BELOW_MICRO_SECONDS_1 = 0x0,
+    BELOW_MICRO_SECONDS_2 = 0x1,
+    BELOW_MICRO_SECONDS_4 = 0x2,
+    BELOW_MICRO_SECONDS_8 = 0x3,
+    BELOW_MICRO_SECONDS_16 = 0x4,
+    BELOW_MICRO_SECONDS_32 = 0x5,
+    UP_TO_MICRO_SECONDS_64 = 0x6,
+    ABOVE_MICRO_SECONDS_64 = 0x7,
+};
+
+/**
+ * @brief number of MSI vectors the device requests, log2 encoded
+ */
+enum class MSI_MULTIPLE_MESSAGE_CAPABLE
+{
+    VECTORS_1 = 0x0,
+    VECTORS_2 = 0x1,
+    VECTORS_4 = 0x2,
+    VECTORS_8 = 0x3,
+    VECTORS_16 = 0x4,
+    VECTORS_32 = 0x5,
+};
+
+/**
+ * @brief number of MSI-X table entries, encoded as N - 1
+ */
+enum class MSIX_TABLE_SIZE
+{
+    VECTORS_1 = 0x0,
+    VECTORS_2 = 0x1,
+    VECTORS_3 = 0x2,
+    VECTORS_4 = 0x3,
+    VECTORS_5 = 0x4,
+    VECTORS_6 = 0x5,
+    VECTORS_7 = 0x6,
+    VECTORS_8 = 0x7,
+};
+
+/**
+ * @brief unit of the T_POWER_ON value
+ */
+enum class T_POWER_ON_SCALE
+{
+    MICRO_SECONDS_2 = 0x0,
+    MICRO_SECONDS_10 = 0x1,
+    MICRO_SECONDS_100 = 0x2,
+    // RESERVED = 0x3,
+};
+
 enum class MAC_CONFIGURATION
 {
     MPBS_10 = 0x0,
@@ -263,6 +365,20 @@ struct EEPROM_CONFIG
     LED_PULSING ledPulsing{ LED_PULSING::NORMAL_OPERATION };
     BLINK_PULSE_STRETCH_RATE blinkPulseStretchRate{ BLINK_PULSE_STRETCH_RATE::HZ_2_5_400MS };
     LED_ACTIVITY_OUTPUT ledActivityOutput{ LED_ACTIVITY_OUTPUT::ACTIVE_LOW };
+    // the enable bits are only set for values != VECTORS_1, which keep the hardware default
+    MSI_MULTIPLE_MESSAGE_CAPABLE msiMultipleMessageCapable{
+        MSI_MULTIPLE_MESSAGE_CAPABLE::VECTORS_1
+    };
+    MSIX_TABLE_SIZE msixTableSize{ MSIX_TABLE_SIZE::VECTORS_1 };
+    // like the vector counts, the first value of each enum keeps the hardware default
+    L0S_ACCEPTABLE_LATENCY l0sAcceptableLatency{ L0S_ACCEPTABLE_LATENCY::NANO_SECONDS_64 };
+    L1_ACCEPTABLE_LATENCY l1AcceptableLatency{ L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_1 };
+    L0S_EXIT_LATENCY l0sExitLatency{ L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_64 };
+    L1_EXIT_LATENCY l1ExitLatency{ L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_1 };
+    // L1.2 exit timing, see \ref setCommonModeRestoreTime and \ref setTPowerOn
+    Byte commonModeRestoreTime{ 0 };  // us
+    Byte tPowerOnValue{ 0 };          // 0 - 31
+    T_POWER_ON_SCALE tPowerOnScale{ T_POWER_ON_SCALE::MICRO_SECONDS_2 };
 };
 
 struct EEPROM
@@ -276,14 +392,14 @@ struct EEPROM
     Byte16 subsystemVendorID;             // 0x0b - 0x0c
     Byte16 subsystemID;                   // 0x0d - 0x0e
     Byte powerManagementCapabilities;     // 0x0f
-    Byte byte16;                          // 0x10 unused
-    Byte byte17;                          // 0x11 unused
+    Byte msiCapabilities;                 // 0x10
+    Byte endpointAcceptableLatency;       // 0x11
     Byte deviceCapabilities_1;            // 0x12
     Byte byte19;                          // 0x13 unused
     Byte deviceCapabilities_2;            // 0x14
     Byte l1PMSubstatesCapabilites;        // 0x15
-    Byte byte22;                          // 0x16 unused
-    Byte byte23;                          // 0x17 unused
+    Byte portCommonModeRestoreTime;       // 0x16
+    Byte portTPowerOn;                    // 0x17
     Byte aspmConfig;                      // 0x18
     Byte byte25;                          // 0x19 unused
     Byte byte26;                          // 0x1a unused
@@ -299,16 +415,26 @@ struct EEPROM
             - (sizeof(magic) + sizeof(mac) + sizeof(byte7) + sizeof(deviceCapabilitiesEnable_1_2)
                + sizeof(l1PMSubstatesCapabilitesEnable) + sizeof(aspmConfigEnable)
                + sizeof(subsystemVendorID) + sizeof(subsystemID)
-               + sizeof(powerManagementCapabilities) + sizeof(byte16) + sizeof(byte17)
-               + sizeof(deviceCapabilities_1) + sizeof(byte19) + sizeof(deviceCapabilities_2)
-               + sizeof(l1PMSubstatesCapabilites) + sizeof(byte22) + sizeof(byte23)
-               + sizeof(aspmConfig) + sizeof(byte25) + sizeof(byte26) + sizeof(macConfig1)
-               + sizeof(macConfig2) + sizeof(ledConfig1) + sizeof(ledConfig2) + sizeof(ledConfig3))>
+               + sizeof(powerManagementCapabilities) + sizeof(msiCapabilities)
+               + sizeof(endpointAcceptableLatency) + sizeof(deviceCapabilities_1) + sizeof(byte19)
+               + sizeof(deviceCapabilities_2) + sizeof(l1PMSubstatesCapabilites)
+               + sizeof(portCommonModeRestoreTime) + sizeof(portTPowerOn) + sizeof(aspmConfig)
+               + sizeof(byte25) + sizeof(byte26) + sizeof(macConfig1) + sizeof(macConfig2)
+               + sizeof(ledConfig1) + sizeof(ledConfig2) + sizeof(ledConfig3))>
         base_config;
 };
 #pragma pack(pop)
 static constexpr int eeprom_user_defined_size = base_eeprom_len - sizeof(EEPROM::base_config);
 
+/**
+ * @brief caller provided buffer of the non throwing codec functions, e.g. a slot of a mapped file
+ */
+using EepromBytes = std::array<Byte, base_eeprom_len>;
+static_assert(sizeof(EEPROM) == sizeof(EepromBytes));
+
+/// length of XX-XX-XX-XX-XX-XX, the strings are not null terminated
+static constexpr size_t mac_string_len = 17;
+
 /**
  * \brief parses a MAC address string
  * takes strings of format XX:XX:XX:XX:XX:XX or XX-XX-XX-XX-XX-XX and returns it as \typedef Mac
@@ -317,12 +443,86 @@ static constexpr int eeprom_user_defined_size = base_eeprom_len - sizeof(EEPROM:
  * \return Mac
  */
 LAN7430_CONFIG_LIB_EXPORT Mac stringToMac(const std::string& macString) noexcept(false);
+/**
+ * @brief non throwing, allocation free variant of \ref stringToMac, accepts the same strings
+ * @param macString
+ * @param mac only written on success
+ * @return ifm::MAC_ADDRESS_EMPTY, ifm::MAC_ADDRESS_INVALID or empty on success
+ */
+LAN7430_CONFIG_LIB_EXPORT std::error_code parseMac(std::string_view macString, Mac& mac) noexcept;
+/**
+ * @brief parses many MAC address strings at once, e.g. a column of an import file
+ * @param macStrings
+ * @param macs resized to the number of strings, all zero for invalid strings
+ * @param errors resized to the number of strings, the result of \ref parseMac per string
+ * @return number of invalid strings
+ */
+LAN7430_CONFIG_LIB_EXPORT size_t parseMacs(const std::vector<std::string_view>& macStrings,
+                                           std::vector<Mac>& macs,
+                                           std::vector<std::error_code>& errors) noexcept(false);
 /**
  * \brief creates a string representation of \typedef Mac
  * \param Mac mac
  * \return std::string
  */
 LAN7430_CONFIG_LIB_EXPORT std::string macToString(const Mac& mac);
+/**
+ * @brief allocation free variant of \ref macToString, writes XX-XX-XX-XX-XX-XX (no terminator)
+ * @param mac
+ * @param chars
+ */
+LAN7430_CONFIG_LIB_EXPORT void macToChars(const Mac& mac, char (&chars)[mac_string_len]) noexcept;
+/**
+ * @brief formats \p count MAC addresses into one contiguous buffer, see \ref macToChars
+ * The string of macs[i] starts at buffer + i * stride, the \p stride - \ref mac_string_len
+ * characters in between are left untouched, e.g. a file name suffix or a newline written once.
+ * @param macs
+ * @param count
+ * @param buffer at least (count - 1) * stride + mac_string_len characters
+ * @param stride must be at least \ref mac_string_len
+ */
+LAN7430_CONFIG_LIB_EXPORT void macsToChars(const Mac* macs,
+                                           size_t count,
+                                           char* buffer,
+                                           size_t stride = mac_string_len) noexcept;
+/**
+ * @brief packs a MAC address into the lower 48 bits of an integer, the first byte of the MAC
+ * address becomes the most significant byte, so the integers sort like the MAC addresses
+ * @param mac
+ * @return uint64_t
+ */
+constexpr uint64_t macToInteger(const Mac& mac) noexcept
+{
+    uint64_t value = 0;
+    for (const auto& byte : mac)
+    {
+        value = (value << 8) | byte;
+    }
+    return value;
+}
+/**
+ * @brief inverse of \ref macToInteger, bits above the lower 48 bits are ignored
+ * @param value
+ * @return Mac
+ */
+constexpr Mac integerToMac(uint64_t value) noexcept
+{
+    Mac mac{};
+    for (size_t i = mac.size(); i > 0; --i)
+    {
+        mac[i - 1] = static_cast<Byte>(value & 0xff);
+        value >>= 8;
+    }
+    return mac;
+}
+/**
+ * @brief returns the MAC address that is \p offset addresses after \p mac
+ * the carry is propagated over all 6 bytes, e.g. 00:00:00:00:00:FF + 1 = 00:00:00:00:01:00
+ * @param mac
+ * @param offset
+ * @return Mac
+ */
+LAN7430_CONFIG_LIB_EXPORT Mac incrementMac(const Mac& mac, uint64_t offset = 1) noexcept(false);
 /**
  * @brief validates that a Mac address is not 00:00:00:00:00:00 or FF:FF:FF:FF:FF:FF
  * @param macArray
@@ -335,6 +535,80 @@ LAN7430_CONFIG_LIB_EXPORT bool validateMAC(const Mac& macArray);
  * @return
  */
 LAN7430_CONFIG_LIB_EXPORT void validateEEPROM(const EEPROM& eeprom) noexcept(false);
+/**
+ * @brief non throwing, allocation free variant of \ref validateEEPROM
+ * @param bytes
+ * @return std::error_code of ifm::error_category(), empty if valid
+ */
+LAN7430_CONFIG_LIB_EXPORT std::error_code validateEEPROM(const EepromBytes& bytes) noexcept;
+/**
+ * @brief encodes the config into the caller provided buffer, see \ref createEEPROM
+ * the created EEPROM is validated, on error \p bytes is left untouched. Neither allocates nor
+ * throws, so it can be used in tight loops and signal handlers.
+ * @param config
+ * @param bytes
+ * @return std::error_code of ifm::error_category(), empty on success
+ */
+LAN7430_CONFIG_LIB_EXPORT std::error_code encodeEEPROM(const EEPROM_CONFIG& config,
+                                                       EepromBytes& bytes) noexcept;
+/**
+ * @brief validates and decodes the caller provided buffer, see \ref eepromConfigToEEPROM
+ * on error \p config is left untouched. Neither allocates nor throws.
+ * @param bytes
+ * @param config
+ * @return std::error_code of ifm::error_category(), empty on success
+ */
+LAN7430_CONFIG_LIB_EXPORT std::error_code decodeEEPROM(const EepromBytes& bytes,
+                                                       EEPROM_CONFIG& config) noexcept;
+
+/// largest Common_Mode_Restore_Time that can be encoded in microseconds
+static constexpr uint32_t common_mode_restore_time_max = 255;
+/// largest T_POWER_ON that can be encoded in microseconds, 31 * 100 us
+static constexpr uint32_t t_power_on_max = 3100;
+/**
+ * @brief sets the Common_Mode_Restore_Time of the port
+ * @param config
+ * @param microSeconds at most \ref common_mode_restore_time_max, ifm::EEPROM_VALUE_OUT_OF_RANGE
+ * otherwise
+ */
+LAN7430_CONFIG_LIB_EXPORT void setCommonModeRestoreTime(EEPROM_CONFIG& config,
+                                                        uint32_t microSeconds) noexcept(false);
+/**
+ * @brief sets T_POWER_ON to the shortest time that can be encoded and is not below
+ * \p microSeconds, e.g. 63 us is encoded as 7 * 10 us
+ * @param config
+ * @param microSeconds at most \ref t_power_on_max, ifm::EEPROM_VALUE_OUT_OF_RANGE otherwise
+ */
+LAN7430_CONFIG_LIB_EXPORT void setTPowerOn(EEPROM_CONFIG& config,
+                                           uint32_t microSeconds) noexcept(false);
+/**
+ * @brief T_POWER_ON of the config in microseconds, 0 for the reserved scale
+ * @param config
+ * @return uint32_t
+ */
+constexpr uint32_t tPowerOnMicroSeconds(const EEPROM_CONFIG& config) noexcept
+{
+    switch (config.tPowerOnScale)
+    {
+        case T_POWER_ON_SCALE::MICRO_SECONDS_2:
+            return config.tPowerOnValue * 2u;
+        case T_POWER_ON_SCALE::MICRO_SECONDS_10:
+            return config.tPowerOnValue * 10u;
+        case T_POWER_ON_SCALE::MICRO_SECONDS_100:
+            return config.tPowerOnValue * 100u;
+    }
+    return 0;
+}
+/**
+ * @brief time the port needs to leave L1.2 in microseconds, T_POWER_ON followed by the
+ * Common_Mode_Restore_Time
+ * @param config
+ * @return uint32_t
+ */
+constexpr uint32_t l12ExitMicroSeconds(const EEPROM_CONFIG& config) noexcept
+{
+    return tPowerOnMicroSeconds(config) + config.commonModeRestoreTime;
+}
 
 /**
  * @brief creates a EEPROM_CONFIG from the given EEPROM
@@ -342,12 +616,25 @@ LAN7430_CONFIG_LIB_EXPORT void validateEEPROM(const EEPROM& eeprom) noexcept(fal
  * @return
  */
 LAN7430_CONFIG_LIB_EXPORT EEPROM_CONFIG eepromConfigToEEPROM(EEPROM eeprom) noexcept(false);
+/**
+ * @brief constexpr variant of \ref eepromConfigToEEPROM, defined in fields.hpp
+ * @param eeprom
+ * @return
+ */
+constexpr EEPROM_CONFIG eepromConfigToEEPROMConstexpr(const EEPROM& eeprom) noexcept;
 /**
  * @brief creates a EEPROM as byte representation from the given EEPROM_CONFIG
  * @param conf
  * @return
  */
 LAN7430_CONFIG_LIB_EXPORT EEPROM createEEPROM(const EEPROM_CONFIG& conf) noexcept(false);
+/**
+ * @brief constexpr variant of \ref createEEPROM, so golden images can be created at compile
+ * time, defined in fields.hpp
+ * @param conf
+ * @return
+ */
+constexpr EEPROM createEEPROMConstexpr(const EEPROM_CONFIG& conf) noexcept;
 /**
  * @brief creates a byte representation of the given EEPROM_CONFIG and writes it to the specified
  * path
@@ -357,12 +644,32 @@ LAN7430_CONFIG_LIB_EXPORT EEPROM createEEPROM(const EEPROM_CONFIG& conf) noexcep
  */
 LAN7430_CONFIG_LIB_EXPORT void writeEEPROM(const std::string& filePath,
                                            const EEPROM_CONFIG& config) noexcept(false);
+/**
+ * @brief writes an already created byte representation to the specified path
+ * @param filePath
+ * @param eeprom
+ */
+LAN7430_CONFIG_LIB_EXPORT void writeRawEEPROM(const std::string& filePath,
+                                              const EEPROM& eeprom) noexcept(false);
+/**
+ * @brief atomically replaces the file at the specified path with the given EEPROM
+ * the EEPROM is written to a temporary file in the same folder, which is synced and renamed to
+ * \p filePath, so readers see either the old or the new file, even if the process dies
+ * @param filePath
+ * @param eeprom
+ */
+LAN7430_CONFIG_LIB_EXPORT void replaceEEPROM(const std::string& filePath,
+                                             const EEPROM& eeprom) noexcept(false);
 /**
  * @brief reads the file content into a EEPROM and validates it
+ * use EepromFile to avoid the copy
  * @param filePath
  * @param error
  * @return
  */
 LAN7430_CONFIG_LIB_EXPORT EEPROM readEEPROM(const std::string& filePath) noexcept(false);
 
+// the header only, constexpr codec
+#include "lan7430conf/fields.hpp"
+
 #endif /* LAN7430CONF_HPP */
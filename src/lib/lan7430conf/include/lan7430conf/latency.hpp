@@ -0,0 +1,138 @@
+/** @file latency.hpp
+ *
+ *  @brief contains functions to estimate the wake-up latency caused by the power management
+ *  settings of EEPROM images, without installing the images on a board
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_LATENCY_HPP
+#define LAN7430_LATENCY_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+/// latency of the encodings "more than 4 us", "more than 64 us" and "no limit", in ns
+static constexpr uint64_t latency_unbounded = std::numeric_limits<uint64_t>::max();
+
+/**
+ * @brief latencies implied by the settings of an EEPROM image, all times in ns
+ *
+ * The exit latencies are the upper bounds of the encoded ranges. Settings whose override bit is
+ * cleared are taken as decoded, the LAN7430 uses its hardware default instead, they are listed in
+ * \ref defaults. A power management capability whose override bit is cleared is assumed to be
+ * supported, as its hardware default is unknown.
+ */
+struct LatencyFigures
+{
+    /// idle time before the link enters L0s resp. L1
+    uint64_t l0sEntrance{ 0 };
+    uint64_t l1Entrance{ 0 };
+    /// largest exit latencies the endpoint accepts
+    uint64_t l0sAcceptable{ 0 };
+    uint64_t l1Acceptable{ 0 };
+    uint64_t l0sExit{ 0 };
+    uint64_t l1Exit{ 0 };
+    /// the OS doesn't enable a state whose exit latency exceeds the acceptable latency
+    bool l0sBlocked{ false };
+    bool l1Blocked{ false };
+    /// L1.2 may be supported by the L1 PM substates capability and ASPM or PCI-PM
+    bool l12Enabled{ false };
+    /// L1 exit + T_POWER_ON + Common_Mode_Restore_Time, 0 if L1.2 isn't enabled
+    uint64_t l12Exit{ 0 };
+    /// time to leave Energy Efficient Ethernet LPI (Tw_sys of IEEE 802.3az), 0 without EEE
+    uint64_t eeeWake{ 0 };
+    /// largest exit latency of the states the OS may enable plus \ref eeeWake
+    uint64_t worstWake{ 0 };
+    /// names of the latency and power management fields that keep the hardware default
+    std::vector<std::string> defaults;
+
+    bool operator==(const LatencyFigures& other) const noexcept;
+    bool operator!=(const LatencyFigures& other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * @brief largest acceptable latencies in ns, a latency_unbounded member isn't checked
+ */
+struct LatencyBudget
+{
+    uint64_t l0sExit{ latency_unbounded };
+    uint64_t l1Exit{ latency_unbounded };
+    uint64_t l12Exit{ latency_unbounded };
+    uint64_t eeeWake{ latency_unbounded };
+    uint64_t worstWake{ latency_unbounded };
+    /// fields that keep the hardware default are a violation, as their latency is unknown
+    bool strict{ false };
+};
+
+/**
+ * @brief images of a file that have the same figures
+ */
+struct LatencyReport
+{
+    /// EEPROM, container or lot file
+    std::string location;
+    uint64_t images{ 0 };
+    LatencyFigures figures;
+    /// names of the figures that exceed the budget, e.g. "l1Exit", or "defaults"
+    std::vector<std::string> violations;
+};
+
+struct LatencyAnalysis
+{
+    uint64_t files{ 0 };
+    uint64_t images{ 0 };
+    /// images that exceed the budget
+    uint64_t violations{ 0 };
+    /// files that are neither EEPROM, container nor lot files or can't be read
+    std::vector<std::string> skipped;
+    /// sorted by location
+    std::vector<LatencyReport> reports;
+};
+
+/**
+ * @brief computes the latencies implied by the power management settings of \p eeprom
+ * @param eeprom
+ * @return LatencyFigures
+ */
+LAN7430_CONFIG_LIB_EXPORT LatencyFigures latencyFigures(const EEPROM& eeprom);
+
+/**
+ * @brief compares the figures against the budget, blocked states aren't checked
+ * @param figures
+ * @param budget
+ * @return std::vector<std::string> names of the figures that exceed the budget
+ */
+LAN7430_CONFIG_LIB_EXPORT std::vector<std::string> checkLatencyBudget(
+    const LatencyFigures& figures,
+    const LatencyBudget& budget);
+
+/**
+ * @brief formats a latency in ns, e.g. "512ns", "16.5us" or "unbounded"
+ * @param nanoSeconds
+ * @return std::string
+ */
+LAN7430_CONFIG_LIB_EXPORT std::string latencyToString(uint64_t nanoSeconds);
+
+/**
+ * @brief computes the latency figures of all images in EEPROM, container and lot files and
+ * checks them against \p budget
+ *
+ * Directories are searched recursively and the files are analyzed in parallel. The images of a
+ * lot share their settings, the images of a container are grouped by their figures.
+ * @param paths files and directories
+ * @param budget
+ * @param threads number of worker threads, 0 uses std::thread::hardware_concurrency()
+ * @return LatencyAnalysis
+ */
+LAN7430_CONFIG_LIB_EXPORT LatencyAnalysis analyzeLatency(const std::vector<std::string>& paths,
+                                                         const LatencyBudget& budget,
+                                                         unsigned int threads = 0) noexcept(false);
+
+#endif  // LAN7430_LATENCY_HPP
@@ -0,0 +1,101 @@
+/** @file ledger.hpp
+ *
+ *  @brief contains a crash-safe MAC address allocator shared between processes
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_LEDGER_HPP
+#define LAN7430_LEDGER_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/mac48.hpp"
+#include "lan7430conf/mappedfile.hpp"
+
+#include <cstdint>
+#include <string>
+
+/* Layout of a ledger file, all integers are in host byte order as the file is used for atomic
+ * operations through a shared memory mapping
+ *
+ * 0x00 - 0x3f : header, see MAC_LEDGER_HEADER
+ *
+ * Every issued MAC address is appended to "<ledger>.journal" as 48 bit integer (uint64) and the
+ * journal is synced before the address is handed out. When a ledger is opened, the next address
+ * is moved behind the highest journaled address, so even if the update of the mapped header got
+ * lost (power failure), no address is issued twice.
+ */
+static constexpr char mac_ledger_magic[8] = { 'L', '7', '4', '3', '0', 'M', 'A', 'C' };
+static constexpr uint32_t mac_ledger_version = 1;
+
+struct MAC_LEDGER_HEADER
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved0;
+    uint64_t first;
+    uint64_t last;
+    uint64_t next;  // only accessed atomically
+    std::array<Byte, 24> reserved1;
+};
+
+/**
+ * @brief hands out the MAC addresses of the range [first, last] exactly once
+ *
+ * Any number of processes (and threads, each with its own MacLedger) can allocate from the same
+ * ledger file, the allocation is a lock-free atomic fetch-add on the mapped file.
+ */
+class LAN7430_CONFIG_LIB_EXPORT MacLedger
+{
+public:
+    /**
+     * @brief creates a new ledger file for the range [first, last], fails if the file exists
+     * @param filePath
+     * @param first
+     * @param last
+     */
+    static void create(const std::string& filePath, const Mac& first, const Mac& last) noexcept(
+        false);
+
+    explicit MacLedger(const std::string& filePath) noexcept(false);
+    ~MacLedger();
+
+    MacLedger(const MacLedger&) = delete;
+    MacLedger& operator=(const MacLedger&) = delete;
+
+    /**
+     * @brief returns the next unused MAC address of the range
+     * The address is journaled and synced to disk before it is returned.
+     * @return Mac
+     */
+    Mac allocate() noexcept(false);
+
+    Mac first() const noexcept;
+    Mac last() const noexcept;
+    /// all addresses of the ledger, allocated or not
+    MacRange range() const noexcept;
+    /**
+     * @brief number of MAC addresses that can still be allocated
+     * @return uint64_t
+     */
+    uint64_t remaining() const noexcept;
+
+    /**
+     * @brief path of the journal that belongs to the given ledger
+     * @param filePath
+     * @return std::string
+     */
+    static std::string journalPath(const std::string& filePath);
+
+private:
+    MAC_LEDGER_HEADER* header() noexcept;
+    const MAC_LEDGER_HEADER* header() const noexcept;
+    void recover() noexcept(false);
+
+    MappedFile m_file;
+    int m_journal{ -1 };
+};
+
+#endif  // LAN7430_LEDGER_HPP
@@ -0,0 +1,102 @@
+/** @file lot.hpp
+ *
+ *  @brief contains a compact store for a production lot of images that only differ in the MAC
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_LOT_HPP
+#define LAN7430_LOT_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Layout of a lot file, all integers are little endian
+ *
+ * 0x000 - 0x01f : header, see EEPROM_LOT_HEADER
+ * 0x020 - 0x21f : base image, its MAC address is ignored
+ * 0x220         : count * 6 bytes, the MAC addresses of the lot
+ */
+static constexpr char eeprom_lot_magic[8] = { 'L', '7', '4', '3', '0', 'L', 'O', 'T' };
+static constexpr uint32_t eeprom_lot_version = 1;
+
+#pragma pack(push, 1)
+struct EEPROM_LOT_HEADER
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t imageSize;
+    uint64_t count;
+    std::array<Byte, 8> reserved;
+};
+#pragma pack(pop)
+static_assert(sizeof(EEPROM_LOT_HEADER) == 32, "lot header must be 32 bytes");
+
+/**
+ * @brief one base image and the MAC addresses of all boards of a lot
+ *
+ * Only 6 bytes are stored per board, the images are created on demand by patching the MAC address
+ * into a copy of the base image.
+ */
+class LAN7430_CONFIG_LIB_EXPORT EepromLot
+{
+public:
+    explicit EepromLot(const EEPROM& base, std::vector<Mac> macs = {}) noexcept;
+
+    /**
+     * @brief checks whether the file at the given path starts with the lot magic
+     * @param filePath
+     * @return bool
+     */
+    static bool isLot(const std::string& filePath) noexcept;
+
+    const EEPROM& base() const noexcept { return m_base; }
+    const std::vector<Mac>& macs() const noexcept { return m_macs; }
+    size_t size() const noexcept { return m_macs.size(); }
+
+    void add(const Mac& mac) { m_macs.push_back(mac); }
+    /**
+     * @brief adds the MAC address of the given image
+     * throws if the image differs from the base image in anything but the MAC address
+     * @param image
+     */
+    void add(const EEPROM& image) noexcept(false);
+
+    /**
+     * @brief creates the image of the board at the given index
+     * @param index
+     * @return EEPROM
+     */
+    EEPROM image(size_t index) const noexcept(false);
+    /**
+     * @brief creates the image of the board with the given MAC address
+     * @param mac
+     * @return EEPROM
+     */
+    EEPROM image(const Mac& mac) const noexcept(false);
+
+private:
+    EEPROM m_base;
+    std::vector<Mac> m_macs;
+};
+
+/**
+ * @brief writes the lot to the specified path
+ * @param filePath
+ * @param lot
+ */
+LAN7430_CONFIG_LIB_EXPORT void writeEEPROMLot(const std::string& filePath,
+                                              const EepromLot& lot) noexcept(false);
+/**
+ * @brief reads a lot from the specified path
+ * @param filePath
+ * @return EepromLot
+ */
+LAN7430_CONFIG_LIB_EXPORT EepromLot readEEPROMLot(const std::string& filePath) noexcept(false);
+
+#endif  // LAN7430_LOT_HPP
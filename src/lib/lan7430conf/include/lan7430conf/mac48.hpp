@@ -0,0 +1,230 @@
+/** @file mac48.hpp
+ *
+ *  @brief contains value types for MAC address arithmetic and ranges of MAC addresses
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_MAC48_HPP
+#define LAN7430_MAC48_HPP
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+/**
+ * @brief a MAC address held as 48 bit integer, see \ref macToInteger
+ *
+ * Converts implicitly from and to \ref Mac, so it can be passed to all functions taking a Mac.
+ * All operations are constant time, arithmetic that leaves the 48 bit space throws
+ * ifm::MAC_ADDRESS_OVERFLOW.
+ */
+class Mac48
+{
+public:
+    static constexpr uint64_t max_value = (uint64_t(1) << (std::tuple_size<Mac>::value * 8)) - 1;
+
+    constexpr Mac48() noexcept = default;
+    /// bits above the lower 48 bits are ignored
+    constexpr explicit Mac48(uint64_t value) noexcept
+    : m_value(value & max_value)
+    {
+    }
+    constexpr Mac48(const Mac& mac) noexcept
+    : m_value(macToInteger(mac))
+    {
+    }
+    constexpr operator Mac() const noexcept { return integerToMac(m_value); }
+
+    constexpr uint64_t value() const noexcept { return m_value; }
+    /// organizationally unique identifier, the upper 24 bits
+    constexpr uint32_t oui() const noexcept { return static_cast<uint32_t>(m_value >> 24); }
+    /// network interface controller specific part, the lower 24 bits
+    constexpr uint32_t nic() const noexcept { return static_cast<uint32_t>(m_value & 0xffffff); }
+
+    constexpr Mac48 operator+(uint64_t offset) const noexcept(false)
+    {
+        if (offset > max_value - m_value)
+        {
+            throw ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW);
+        }
+        return Mac48(m_value + offset);
+    }
+    constexpr Mac48 operator-(uint64_t offset) const noexcept(false)
+    {
+        if (offset > m_value)
+        {
+            throw ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW);
+        }
+        return Mac48(m_value - offset);
+    }
+    constexpr Mac48& operator+=(uint64_t offset) noexcept(false) { return *this = *this + offset; }
+    constexpr Mac48& operator++() noexcept(false) { return *this += 1; }
+
+    /// number of addresses from \p first to \p last, negative if \p last is before \p first
+    friend constexpr int64_t distance(Mac48 first, Mac48 last) noexcept
+    {
+        return static_cast<int64_t>(last.m_value) - static_cast<int64_t>(first.m_value);
+    }
+
+    friend constexpr bool operator==(Mac48 a, Mac48 b) noexcept { return a.m_value == b.m_value; }
+    friend constexpr bool operator!=(Mac48 a, Mac48 b) noexcept { return a.m_value != b.m_value; }
+    friend constexpr bool operator<(Mac48 a, Mac48 b) noexcept { return a.m_value < b.m_value; }
+    friend constexpr bool operator<=(Mac48 a, Mac48 b) noexcept { return a.m_value <= b.m_value; }
+    friend constexpr bool operator>(Mac48 a, Mac48 b) noexcept { return a.m_value > b.m_value; }
+    friend constexpr bool operator>=(Mac48 a, Mac48 b) noexcept { return a.m_value >= b.m_value; }
+
+    std::string toString() const { return macToString(*this); }
+
+private:
+    uint64_t m_value{ 0 };
+};
+
+/**
+ * @brief the consecutive MAC addresses [first, first + size)
+ *
+ * A range may hold the whole 48 bit space, an empty range has no first or last address.
+ */
+class MacRange
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Mac48;
+        using difference_type = int64_t;
+        using pointer = const Mac48*;
+        using reference = Mac48;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(uint64_t value) noexcept
+        : m_value(value)
+        {
+        }
+        constexpr Mac48 operator*() const noexcept { return Mac48(m_value); }
+        constexpr iterator& operator++() noexcept
+        {
+            ++m_value;
+            return *this;
+        }
+        constexpr iterator operator++(int) noexcept
+        {
+            iterator previous = *this;
+            ++m_value;
+            return previous;
+        }
+        friend constexpr bool operator==(iterator a, iterator b) noexcept
+        {
+            return a.m_value == b.m_value;
+        }
+        friend constexpr bool operator!=(iterator a, iterator b) noexcept
+        {
+            return a.m_value != b.m_value;
+        }
+
+    private:
+        // one past the last address may be 2^48, so this is not a Mac48
+        uint64_t m_value{ 0 };
+    };
+
+    constexpr MacRange() noexcept = default;
+    /// throws ifm::MAC_ADDRESS_OVERFLOW if the range doesn't fit into the 48 bit space
+    constexpr MacRange(Mac48 first, uint64_t size) noexcept(false)
+    : m_first(first.value())
+    , m_size(size)
+    {
+        if (size > Mac48::max_value - m_first + 1)
+        {
+            throw ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW);
+        }
+    }
+    /// the range [first, last], empty if \p last is before \p first
+    static constexpr MacRange closed(Mac48 first, Mac48 last) noexcept
+    {
+        MacRange range;
+        range.m_first = first.value();
+        range.m_size = last < first ? 0 : distance(first, last) + 1;
+        return range;
+    }
+
+    constexpr uint64_t size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    /// only valid if not empty
+    constexpr Mac48 first() const noexcept { return Mac48(m_first); }
+    /// only valid if not empty
+    constexpr Mac48 last() const noexcept { return Mac48(m_first + m_size - 1); }
+    /// the address at \p offset, throws ifm::MAC_ADDRESS_OVERFLOW if not within the range
+    constexpr Mac48 operator[](uint64_t offset) const noexcept(false)
+    {
+        if (offset >= m_size)
+        {
+            throw ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW);
+        }
+        return Mac48(m_first + offset);
+    }
+
+    constexpr bool contains(Mac48 mac) const noexcept
+    {
+        return mac.value() >= m_first && mac.value() - m_first < m_size;
+    }
+    /// an empty range is contained in every range
+    constexpr bool contains(const MacRange& other) const noexcept
+    {
+        return other.empty()
+               || (other.m_first >= m_first && other.m_first - m_first + other.m_size <= m_size);
+    }
+    constexpr bool overlaps(const MacRange& other) const noexcept
+    {
+        return !intersection(other).empty();
+    }
+    /// the addresses in both ranges, empty if they don't overlap
+    constexpr MacRange intersection(const MacRange& other) const noexcept
+    {
+        const uint64_t begin = m_first > other.m_first ? m_first : other.m_first;
+        const uint64_t end = endValue() < other.endValue() ? endValue() : other.endValue();
+        MacRange range;
+        range.m_first = begin;
+        range.m_size = end > begin ? end - begin : 0;
+        return range;
+    }
+
+    constexpr iterator begin() const noexcept { return iterator(m_first); }
+    constexpr iterator end() const noexcept { return iterator(endValue()); }
+
+    /**
+     * @brief formats all addresses of the range, see \ref macsToChars
+     * @param buffer at least (size() - 1) * stride + mac_string_len characters
+     * @param stride
+     */
+    void toChars(char* buffer, size_t stride = mac_string_len) const noexcept
+    {
+        for (const Mac48 mac : *this)
+        {
+            const Mac bytes = mac;
+            macsToChars(&bytes, 1, buffer, stride);
+            buffer += stride;
+        }
+    }
+
+    friend constexpr bool operator==(const MacRange& a, const MacRange& b) noexcept
+    {
+        return a.m_size == b.m_size && (a.m_size == 0 || a.m_first == b.m_first);
+    }
+    friend constexpr bool operator!=(const MacRange& a, const MacRange& b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    constexpr uint64_t endValue() const noexcept { return m_first + m_size; }
+
+    uint64_t m_first{ 0 };
+    uint64_t m_size{ 0 };
+};
+
+#endif  // LAN7430_MAC48_HPP
@@ -0,0 +1,57 @@
+/** @file mappedfile.hpp
+ *
+ *  @brief contains a RAII wrapper around a memory mapped file
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_MAPPEDFILE_HPP
+#define LAN7430_MAPPEDFILE_HPP
+
+#include "lan7430conf/byte.hpp"
+#include "lan7430conf/lan7430-config-lib_export.h"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief maps a whole file into memory, the mapping is released when the object is destroyed
+ *
+ * READ_WRITE mappings are shared, i.e. writes are visible to other processes mapping the same file
+ * and end up in the file.
+ */
+class LAN7430_CONFIG_LIB_EXPORT MappedFile
+{
+public:
+    enum class Mode
+    {
+        READ_ONLY,
+        READ_WRITE,
+    };
+
+    explicit MappedFile(const std::string& filePath, Mode mode = Mode::READ_ONLY) noexcept(false);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const Byte* data() const noexcept { return m_data; }
+    Byte* data() noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+
+    /**
+     * @brief flushes the changes of a READ_WRITE mapping to the file (msync)
+     */
+    void sync() noexcept(false);
+
+private:
+    void unmap() noexcept;
+
+    Byte* m_data{ nullptr };
+    size_t m_size{ 0 };
+};
+
+#endif  // LAN7430_MAPPEDFILE_HPP
@@ -0,0 +1,87 @@
+/** @file profile.hpp
+ *
+ *  @brief contains named sets of configuration values that are applied in one step
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_PROFILE_HPP
+#define LAN7430_PROFILE_HPP
+
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief a named set of EEPROM_CONFIG values, fields not in the set keep their value
+ */
+struct ConfigProfile
+{
+    std::string name;
+    std::string description;
+    /// JSON object of member names and values, see \ref applyConfigRecord
+    std::string settings;
+    /// fields whose override bit is set even if their value is 0, otherwise the LAN7430 keeps its
+    /// hardware default for them, see \ref overrideValue
+    std::vector<std::string> overrides;
+};
+
+/**
+ * @brief a member of EEPROM_CONFIG that differs, the values are the raw values of the field
+ * (macToInteger for "mac")
+ */
+struct FieldChange
+{
+    std::string name;
+    uint64_t before;
+    uint64_t after;
+    /// the override bit of the field was set, \ref before and \ref after may be equal
+    bool overridden{ false };
+};
+
+/**
+ * @brief the profiles that come with the library, e.g. "low-latency"
+ * @return const std::vector<ConfigProfile>&
+ */
+LAN7430_CONFIG_LIB_EXPORT const std::vector<ConfigProfile>& builtinProfiles() noexcept;
+
+/**
+ * @brief returns the built in profile of the given name, otherwise reads the profile file at the
+ * given path
+ *
+ * A profile file contains the settings only, e.g. {"energyEfficientEthernet": false}, its name
+ * is the file name without extension. The settings are checked before the profile is returned.
+ * Every flag or enum with an override bit that the file sets to 0 is added to
+ * \ref ConfigProfile::overrides.
+ * @param nameOrPath
+ * @return ConfigProfile
+ */
+LAN7430_CONFIG_LIB_EXPORT ConfigProfile findProfile(const std::string& nameOrPath) noexcept(false);
+
+/**
+ * @brief lists the members that differ between \p before and \p after, in the order of
+ * \ref eeprom_fields, the MAC address comes first
+ * @param before
+ * @param after
+ * @return std::vector<FieldChange>
+ */
+LAN7430_CONFIG_LIB_EXPORT std::vector<FieldChange> diffConfig(const EEPROM_CONFIG& before,
+                                                              const EEPROM_CONFIG& after);
+
+/**
+ * @brief applies the settings of the profile to \p eeprom
+ * Only the fields that change and the fields of \ref ConfigProfile::overrides whose override bit
+ * is cleared are encoded, so bits unknown to this library are preserved.
+ * @param profile
+ * @param eeprom
+ * @return std::vector<FieldChange> the fields that changed
+ */
+LAN7430_CONFIG_LIB_EXPORT std::vector<FieldChange> applyProfile(const ConfigProfile& profile,
+                                                                EepromRef& eeprom) noexcept(false);
+
+#endif  // LAN7430_PROFILE_HPP
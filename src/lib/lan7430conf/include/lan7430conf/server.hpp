@@ -0,0 +1,107 @@
+/** @file server.hpp
+ *
+ *  @brief contains a server creating EEPROM images for requests received on a Unix socket
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_SERVER_HPP
+#define LAN7430_SERVER_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Protocol, all integers are 32 bit unsigned in host byte order (the socket is local):
+ *
+ * request:  length, payload of length bytes
+ *   - template image (512 bytes) + MAC address (6 bytes): the template is remembered by the
+ *     connection and the MAC address is put into it
+ *   - MAC address (6 bytes): uses the template of the previous request of the connection
+ *
+ * reply:    length, status, payload of length - 4 bytes
+ *   - status 0: the EEPROM image (512 bytes)
+ *   - otherwise status is one of the error codes of errors.hpp and the payload its message
+ *
+ * A client may send any number of requests without waiting for the replies, they are answered
+ * in order. Requests longer than server_max_request_len close the connection.
+ */
+static constexpr uint32_t server_max_request_len = 4096;
+
+struct ServerStatistics
+{
+    uint64_t connections{ 0 };
+    uint64_t requests{ 0 };
+    /// requests answered with an error
+    uint64_t errors{ 0 };
+    /// time from the request being received to its reply being written
+    std::chrono::nanoseconds p50{ 0 };
+    std::chrono::nanoseconds p90{ 0 };
+    std::chrono::nanoseconds p99{ 0 };
+    std::chrono::nanoseconds p999{ 0 };
+    std::chrono::nanoseconds max{ 0 };
+};
+
+/**
+ * @brief listens on a Unix socket and answers the requests of every connection in its own thread
+ */
+class LAN7430_CONFIG_LIB_EXPORT EepromServer
+{
+public:
+    /**
+     * @brief binds and listens on \p socketPath, a stale socket file is replaced
+     * @param socketPath
+     */
+    explicit EepromServer(const std::string& socketPath) noexcept(false);
+    ~EepromServer();
+    EepromServer(const EepromServer&) = delete;
+    EepromServer& operator=(const EepromServer&) = delete;
+
+    /**
+     * @brief accepts connections until \ref stop is called, then closes all connections and
+     * returns once their threads are finished
+     */
+    void run() noexcept(false);
+
+    /**
+     * @brief makes \ref run return, may be called from any thread and from signal handlers
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief statistics of the connections closed so far, latencies are percentiles over all of
+     * their requests, taken from a histogram that rounds them up by less than 1/64
+     * @return ServerStatistics
+     */
+    ServerStatistics statistics() const;
+
+private:
+    struct Connection;
+
+    void serve(Connection& connection) noexcept;
+    void reap(bool all);
+
+    std::string m_socketPath;
+    int m_listenFd{ -1 };
+    int m_stopPipe[2]{ -1, -1 };
+
+    mutable std::mutex m_mutex;
+    std::list<std::unique_ptr<Connection>> m_connections;
+    uint64_t m_connectionCount{ 0 };
+    uint64_t m_requests{ 0 };
+    uint64_t m_errors{ 0 };
+    /// requests per latency bucket, a histogram of fixed size however many requests are served
+    std::vector<uint64_t> m_latencyCounts;
+    uint64_t m_maxLatency{ 0 };  // nanoseconds
+};
+
+#endif  // LAN7430_SERVER_HPP
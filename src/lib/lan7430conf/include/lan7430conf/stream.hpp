@@ -0,0 +1,76 @@
+/** @file stream.hpp
+ *
+ *  @brief contains functions to create EEPROM images for a stream of newline delimited JSON
+ *  records
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#ifndef LAN7430_STREAM_HPP
+#define LAN7430_STREAM_HPP
+
+#include "lan7430conf/lan7430-config-lib_export.h"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/// longer records are answered with ifm::STREAM_INVALID_RECORD without being buffered
+static constexpr size_t stream_max_record_len = 64 * 1024;
+
+enum class STREAM_FORMAT
+{
+    /// 32 bit length, 32 bit status, image or error message, like the replies of EepromServer
+    BINARY,
+    /// one JSON object per line: {"record":1,"mac":"...","image":"<base64>"} or
+    /// {"record":1,"error":1001,"message":"..."}
+    JSON,
+};
+
+struct StreamStatistics
+{
+    uint64_t records{ 0 };
+    /// records answered with an error
+    uint64_t errors{ 0 };
+};
+
+/**
+ * @brief applies a JSON record to \p config
+ *
+ * The record is an object with the members of EEPROM_CONFIG, see the names of \ref eeprom_fields.
+ * Nested objects and arrays are the same as dotted names: {"ledConfig":[{"enable":false}]} and
+ * {"ledConfig[0].enable":false} are equivalent. "mac" is a string as accepted by stringToMac, all
+ * other values are numbers (the raw value of enums) or booleans. Members not in the record keep
+ * their value.
+ * @param record
+ * @param config
+ */
+LAN7430_CONFIG_LIB_EXPORT void applyConfigRecord(const std::string& record,
+                                                 EEPROM_CONFIG& config) noexcept(false);
+
+/**
+ * @brief reads newline delimited JSON records from \p in and writes one reply per record to
+ * \p out, see \ref applyConfigRecord and \ref STREAM_FORMAT
+ *
+ * Reading and splitting, parsing and encoding, and writing run in their own threads, connected by
+ * queues holding at most \p queueDepth batches of records, so memory stays bounded however long
+ * the stream is. Only the bytes \p in has available are read and \p out is flushed after every
+ * batch, so the records of a live feed are answered as they arrive. Empty lines are skipped, the
+ * record number is the line number.
+ * @param in
+ * @param out
+ * @param defaults configuration the records are applied to
+ * @param format
+ * @param queueDepth
+ * @return StreamStatistics
+ */
+LAN7430_CONFIG_LIB_EXPORT StreamStatistics streamEEPROMs(std::istream& in,
+                                                         std::ostream& out,
+                                                         const EEPROM_CONFIG& defaults,
+                                                         STREAM_FORMAT format,
+                                                         size_t queueDepth = 16) noexcept(false);
+
+#endif  // LAN7430_STREAM_HPP
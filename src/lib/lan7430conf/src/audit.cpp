@@ -0,0 +1,288 @@
+/** @file audit.cpp
+ *
+ *  @brief contains functions to check large amounts of EEPROM images for duplicate MAC addresses
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/audit.hpp"
+
+#include "lan7430conf/container.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lot.hpp"
+#include "lan7430conf/mac48.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+struct MacEntry
+{
+    Mac48 mac;
+    uint32_t file;
+    uint32_t index;  // position within container/lot files, always 0 for EEPROM files
+};
+
+enum class FileKind
+{
+    EEPROM,
+    CONTAINER,
+    LOT,
+    OTHER,
+};
+
+bool isEepromMagic(Byte magic) noexcept
+{
+    constexpr EEPROM_MAGIC magics[]{ EEPROM_MAGIC::EEPROM,
+                                     EEPROM_MAGIC::EEPROM_MAC,
+                                     EEPROM_MAGIC::EEPROM_OTP1,
+                                     EEPROM_MAGIC::EEPROM_OTP2 };
+    return std::any_of(std::begin(magics), std::end(magics), [&](EEPROM_MAGIC m) {
+        return m == EEPROM_MAGIC(magic);
+    });
+}
+
+/// scans a single file and appends all of its MAC addresses, files that can't be read are OTHER
+FileKind scanFile(const std::string& filePath, uint32_t file, std::vector<MacEntry>& entries)
+{
+    FileKind kind = FileKind::OTHER;
+    Byte head[8]{};
+    {
+        const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return FileKind::OTHER;
+        }
+        struct stat status = {};
+        const bool ok = ::fstat(fd, &status) == 0
+                        && ::pread(fd, head, sizeof(head), 0) == static_cast<ssize_t>(sizeof(head));
+        ::close(fd);
+        if (!ok)
+        {
+            return FileKind::OTHER;
+        }
+
+        if (std::memcmp(head, eeprom_container_magic, sizeof(head)) == 0)
+        {
+            kind = FileKind::CONTAINER;
+        }
+        else if (std::memcmp(head, eeprom_lot_magic, sizeof(head)) == 0)
+        {
+            kind = FileKind::LOT;
+        }
+        else if ((status.st_size == 255 || status.st_size == base_eeprom_len)
+                 && isEepromMagic(head[0]))
+        {
+            kind = FileKind::EEPROM;
+        }
+    }
+
+    // a truncated container or lot must not abort the audit of all other files
+    const size_t entriesBefore = entries.size();
+    try
+    {
+        switch (kind)
+        {
+            case FileKind::EEPROM:
+            {
+                Mac mac;
+                std::copy(head + 1, head + 1 + mac.size(), mac.begin());
+                entries.push_back({ mac, file, 0 });
+                break;
+            }
+            case FileKind::CONTAINER:
+            {
+                const EepromContainer container(filePath);
+                for (uint64_t i = 0; i < container.size(); ++i)
+                {
+                    entries.push_back({ container.macAt(i), file, uint32_t(i) });
+                }
+                break;
+            }
+            case FileKind::LOT:
+            {
+                const EepromLot lot = readEEPROMLot(filePath);
+                for (size_t i = 0; i < lot.size(); ++i)
+                {
+                    entries.push_back({ lot.macs()[i], file, uint32_t(i) });
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    catch (const ifm::error_type&)
+    {
+        entries.resize(entriesBefore);
+        return FileKind::OTHER;
+    }
+    return kind;
+}
+
+/// LSD radix sort over the 48 bit MAC addresses, 3 passes with 16 bit digits
+void radixSort(std::vector<MacEntry>& entries)
+{
+    constexpr uint32_t digitBits = 16;
+    constexpr size_t buckets = size_t(1) << digitBits;
+
+    std::vector<MacEntry> buffer(entries.size());
+    std::vector<size_t> offsets(buckets);
+    for (uint32_t shift = 0; shift < 48; shift += digitBits)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (const auto& entry : entries)
+        {
+            ++offsets[(entry.mac.value() >> shift) & (buckets - 1)];
+        }
+        size_t sum = 0;
+        for (auto& offset : offsets)
+        {
+            sum += std::exchange(offset, sum);
+        }
+        for (const auto& entry : entries)
+        {
+            buffer[offsets[(entry.mac.value() >> shift) & (buckets - 1)]++] = entry;
+        }
+        entries.swap(buffer);
+    }
+}
+
+}  // namespace
+
+MacAuditResult auditMacs(const std::vector<std::string>& paths, unsigned int threads) noexcept(
+    false)
+{
+    std::vector<std::string> files;
+    for (const auto& path : paths)
+    {
+        if (!std::filesystem::exists(path))
+        {
+            throw ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST);
+        }
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file())
+                {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            files.push_back(path);
+        }
+    }
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(
+        std::max<size_t>(1, std::min<size_t>(threads, files.size())));
+
+    // every worker collects into its own vector and records the kind of each file it scanned
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::vector<MacEntry>> entries(threads);
+    std::vector<FileKind> kinds(files.size(), FileKind::OTHER);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    try
+    {
+        for (unsigned int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                try
+                {
+                    for (size_t i = next++; i < files.size(); i = next++)
+                    {
+                        kinds[i] = scanFile(files[i], static_cast<uint32_t>(i), entries[t]);
+                    }
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+    }
+    catch (...)
+    {
+        // a thread couldn't be started, the running workers stop after their current file
+        next = files.size();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    MacAuditResult result;
+    result.files = files.size();
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (kinds[i] == FileKind::OTHER)
+        {
+            result.skipped.push_back(files[i]);
+        }
+    }
+
+    std::vector<MacEntry> all;
+    for (auto& local : entries)
+    {
+        all.insert(all.end(), local.begin(), local.end());
+        std::vector<MacEntry>().swap(local);
+    }
+    result.images = all.size();
+    radixSort(all);
+
+    const auto location = [&](const MacEntry& entry) {
+        if (kinds[entry.file] == FileKind::EEPROM)
+        {
+            return files[entry.file];
+        }
+        return files[entry.file] + "[" + std::to_string(entry.index) + "]";
+    };
+    for (size_t first = 0; first < all.size();)
+    {
+        size_t last = first + 1;
+        while (last < all.size() && all[last].mac == all[first].mac)
+        {
+            ++last;
+        }
+        if (last - first > 1)
+        {
+            DuplicateMac duplicate{ all[first].mac, {} };
+            for (size_t i = first; i < last; ++i)
+            {
+                duplicate.locations.push_back(location(all[i]));
+            }
+            result.duplicates.push_back(std::move(duplicate));
+        }
+        first = last;
+    }
+    return result;
+}
@@ -0,0 +1,131 @@
+/** @file batch.cpp
+ *
+ *  @brief contains functions to create the EEPROM files for a whole range of MAC addresses
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/batch.hpp"
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/mac48.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void writeFile(const std::string& filePath, const EEPROM& eeprom) noexcept(false)
+{
+    const int fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    const ssize_t written = ::write(fd, &eeprom, sizeof(EEPROM));
+    if (::close(fd) != 0 || written != static_cast<ssize_t>(sizeof(EEPROM)))
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+}
+
+}  // namespace
+
+namespace {
+constexpr char batch_file_suffix[] = "-pad.bin";
+}  // namespace
+
+std::string batchFileName(const Mac& mac) { return macToString(mac) + batch_file_suffix; }
+
+void writeEEPROMBatch(const std::string& directory,
+                      const EEPROM& eeprom,
+                      const Mac& macStart,
+                      uint64_t count,
+                      unsigned int threads) noexcept(false)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (!std::filesystem::is_directory(directory))
+    {
+        throw ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST);
+    }
+    const MacRange range(macStart, count);  // fail before any file is written
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(std::min<uint64_t>(threads, count));
+
+    const std::string prefix = (std::filesystem::path(directory) / "").string();
+    std::atomic<bool> failed{ false };
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    const uint64_t chunk = count / threads;
+    const uint64_t remainder = count % threads;
+    uint64_t first = 0;
+    try
+    {
+        for (unsigned int t = 0; t < threads; ++t)
+        {
+            const uint64_t last = first + chunk + (t < remainder ? 1 : 0);
+            workers.emplace_back([&, t, first, last]() {
+                try
+                {
+                    EEPROM local = eeprom;
+                    // only the MAC part of the path changes, it is formatted in place
+                    std::string filePath = prefix + batchFileName(local.mac);
+                    char* macChars = filePath.data() + prefix.size();
+                    for (uint64_t i = first;
+                         i < last && !failed.load(std::memory_order_relaxed);
+                         ++i)
+                    {
+                        local.mac = range.first() + i;
+                        macsToChars(&local.mac, 1, macChars);
+                        writeFile(filePath, local);
+                    }
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                    failed = true;
+                }
+            });
+            first = last;
+        }
+    }
+    catch (...)
+    {
+        // a thread couldn't be started, the running workers stop after their current file
+        failed = true;
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        throw;
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
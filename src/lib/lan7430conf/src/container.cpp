@@ -0,0 +1,252 @@
+/** @file container.cpp
+ *
+ *  @brief contains a single file format holding many EEPROM images, indexed by MAC address
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/container.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <endian.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace {
+
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void writeAll(int fd, const Byte* data, size_t size) noexcept(false)
+{
+    while (size > 0)
+    {
+        const ssize_t written = ::write(fd, data, size);
+        if (written <= 0)
+        {
+            throw ifm::error_type(ifm::FILE_CANT_WRITE);
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+/// writes all \p chunks, \p chunks is modified by partial writes
+void writeAll(int fd, std::vector<iovec>& chunks) noexcept(false)
+{
+    size_t first = 0;
+    while (first < chunks.size())
+    {
+        ssize_t written = ::writev(fd, &chunks[first], static_cast<int>(chunks.size() - first));
+        if (written <= 0)
+        {
+            throw ifm::error_type(ifm::FILE_CANT_WRITE);
+        }
+        while (written > 0)
+        {
+            iovec& chunk = chunks[first];
+            const size_t length = std::min(chunk.iov_len, static_cast<size_t>(written));
+            chunk.iov_base = static_cast<Byte*>(chunk.iov_base) + length;
+            chunk.iov_len -= length;
+            written -= static_cast<ssize_t>(length);
+            if (chunk.iov_len == 0)
+            {
+                ++first;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+EepromContainer::EepromContainer(const std::string& filePath) noexcept(false)
+: m_file(filePath)
+{
+    if (m_file.size() < sizeof(EEPROM_CONTAINER_HEADER))
+    {
+        throw ifm::error_type(ifm::CONTAINER_INVALID);
+    }
+
+    EEPROM_CONTAINER_HEADER header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    const uint64_t count = le64toh(header.count);
+    const uint64_t indexOffset = le64toh(header.indexOffset);
+    const uint64_t imageOffset = le64toh(header.imageOffset);
+
+    const uint64_t maxCount = m_file.size() / sizeof(EEPROM);
+    if (std::memcmp(header.magic, eeprom_container_magic, sizeof(header.magic)) != 0
+        || le32toh(header.version) != eeprom_container_version
+        || le32toh(header.imageSize) != sizeof(EEPROM) || count > maxCount
+        || indexOffset < sizeof(header) || indexOffset > imageOffset
+        || count * sizeof(uint64_t) > imageOffset - indexOffset || imageOffset > m_file.size()
+        || count * sizeof(EEPROM) > m_file.size() - imageOffset)
+    {
+        throw ifm::error_type(ifm::CONTAINER_INVALID);
+    }
+
+    m_count = count;
+    m_index = m_file.data() + indexOffset;
+    m_images = m_file.data() + imageOffset;
+}
+
+bool EepromContainer::isContainer(const std::string& filePath) noexcept
+{
+    char magic[sizeof(eeprom_container_magic)]{};
+    std::ifstream in(filePath, std::ios::binary | std::ios::in);
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, eeprom_container_magic, sizeof(magic)) == 0;
+}
+
+uint64_t EepromContainer::keyAt(uint64_t index) const noexcept
+{
+    uint64_t key;
+    std::memcpy(&key, m_index + index * sizeof(key), sizeof(key));
+    return le64toh(key);
+}
+
+Mac EepromContainer::macAt(uint64_t index) const noexcept { return integerToMac(keyAt(index)); }
+
+const EEPROM& EepromContainer::imageAt(uint64_t index) const noexcept
+{
+    return *reinterpret_cast<const EEPROM*>(m_images + index * sizeof(EEPROM));
+}
+
+const EEPROM* EepromContainer::find(const Mac& mac) const noexcept
+{
+    const uint64_t key = macToInteger(mac);
+    uint64_t first = 0;
+    uint64_t count = m_count;
+    while (count > 0)
+    {
+        const uint64_t step = count / 2;
+        if (keyAt(first + step) < key)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    if (first < m_count && keyAt(first) == key)
+    {
+        return &imageAt(first);
+    }
+    return nullptr;
+}
+
+const EEPROM& EepromContainer::at(const Mac& mac) const noexcept(false)
+{
+    const EEPROM* eeprom = find(mac);
+    if (eeprom == nullptr)
+    {
+        throw ifm::error_type(ifm::CONTAINER_MAC_NOT_FOUND);
+    }
+    return *eeprom;
+}
+
+void writeEEPROMContainer(const std::string& filePath,
+                          const std::vector<EEPROM>& images) noexcept(false)
+{
+    std::vector<std::pair<uint64_t, size_t>> order(images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        order[i] = { macToInteger(images[i].mac), i };
+    }
+    std::sort(order.begin(), order.end());
+    if (std::adjacent_find(order.begin(), order.end(), [](const auto& a, const auto& b) {
+            return a.first == b.first;
+        }) != order.end())
+    {
+        throw ifm::error_type(ifm::CONTAINER_DUPLICATE_MAC);
+    }
+
+    EEPROM_CONTAINER_HEADER header{};
+    std::memcpy(header.magic, eeprom_container_magic, sizeof(header.magic));
+    header.version = htole32(eeprom_container_version);
+    header.imageSize = htole32(sizeof(EEPROM));
+    header.count = htole64(images.size());
+    const uint64_t indexOffset = sizeof(header);
+    const uint64_t imageOffset
+        = alignUp(indexOffset + images.size() * sizeof(uint64_t), sizeof(EEPROM));
+    header.indexOffset = htole64(indexOffset);
+    header.imageOffset = htole64(imageOffset);
+
+    // header and index are assembled in memory, the images are written from \p images
+    const uint64_t fileSize = imageOffset + images.size() * sizeof(EEPROM);
+    std::vector<Byte> head(imageOffset);
+    std::memcpy(head.data(), &header, sizeof(header));
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const uint64_t key = htole64(order[i].first);
+        std::memcpy(head.data() + indexOffset + i * sizeof(key), &key, sizeof(key));
+    }
+
+    const int fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    try
+    {
+        // reserve the blocks up front, this avoids fragmentation and fails early on a full disk
+        if (::posix_fallocate(fd, 0, static_cast<off_t>(fileSize)) != 0)
+        {
+            throw ifm::error_type(ifm::FILE_CANT_WRITE);
+        }
+        writeAll(fd, head.data(), head.size());
+
+        // one chunk per run of images that are already in MAC order, at most IOV_MAX per call
+        std::vector<iovec> chunks;
+        chunks.reserve(IOV_MAX);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const EEPROM* image = &images[order[i].second];
+            if (!chunks.empty()
+                && static_cast<Byte*>(chunks.back().iov_base) + chunks.back().iov_len
+                       == reinterpret_cast<const Byte*>(image))
+            {
+                chunks.back().iov_len += sizeof(EEPROM);
+                continue;
+            }
+            if (chunks.size() == IOV_MAX)
+            {
+                writeAll(fd, chunks);
+                chunks.clear();
+            }
+            chunks.push_back({ const_cast<EEPROM*>(image), sizeof(EEPROM) });
+        }
+        writeAll(fd, chunks);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+}
+
+EEPROM readEEPROM(const std::string& containerPath, const Mac& mac) noexcept(false)
+{
+    const EepromContainer container(containerPath);
+    EEPROM eeprom = container.at(mac);
+
+    validateEEPROM(eeprom);
+
+    return eeprom;
+}
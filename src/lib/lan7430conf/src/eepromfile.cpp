@@ -0,0 +1,110 @@
+/** @file eepromfile.cpp
+ *
+ *  @brief contains a zero copy reader for EEPROM files
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/eepromfile.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace {
+/// closes the file descriptor on every path out of the scope, the edit callback may throw
+struct FileDescriptor
+{
+    int fd;
+    ~FileDescriptor()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+};
+}  // namespace
+
+EepromFile::EepromFile(const std::string& filePath) noexcept(false)
+: m_file(filePath)
+{
+    // NOTE(MA): the gui (MPLAB Connect) seems to create only files of size 255... even if
+    //           specified to use 512
+    if (m_file.size() != 255 && m_file.size() != base_eeprom_len)
+    {
+        throw ifm::error_type(ifm::EEPROM_WRONG_SIZE);
+    }
+    static const long pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pageSize < base_eeprom_len)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    validateEEPROM(eeprom());
+}
+
+size_t patchEEPROM(const std::string& filePath,
+                   const std::function<void(EepromRef&)>& edit) noexcept(false)
+{
+    const FileDescriptor file{ ::open(filePath.c_str(), O_RDWR | O_CLOEXEC) };
+    const int fd = file.fd;
+    if (fd < 0)
+    {
+        throw ifm::error_type(errno == ENOENT ? ifm::FILE_PATH_DOESNT_EXIST : ifm::FILE_CANT_READ);
+    }
+
+    struct stat status = {};
+    if (::fstat(fd, &status) != 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+    const auto size = static_cast<size_t>(status.st_size);
+    if (size != 255 && size != base_eeprom_len)
+    {
+        throw ifm::error_type(ifm::EEPROM_WRONG_SIZE);
+    }
+
+    EepromBytes original{};
+    if (::pread(fd, original.data(), size, 0) != static_cast<ssize_t>(size))
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    EepromBytes bytes = original;
+    EepromRef ref(bytes);
+    edit(ref);
+    if (const auto error = validateEEPROM(bytes))
+    {
+        throw ifm::error_type(error.value());
+    }
+
+    // only the dirty range [first, last) is written
+    size_t first = 0;
+    while (first < bytes.size() && bytes[first] == original[first])
+    {
+        ++first;
+    }
+    if (first == bytes.size())
+    {
+        return 0;
+    }
+    size_t last = bytes.size();
+    while (bytes[last - 1] == original[last - 1])
+    {
+        --last;
+    }
+
+    const size_t count = last - first;
+    if (::pwrite(fd, bytes.data() + first, count, static_cast<off_t>(first))
+        != static_cast<ssize_t>(count))
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    return count;
+}
@@ -19,12 +19,30 @@ static const std::map<int, const std::string> errToStr = {
     { IFM_NO_ERROR, "Success" },
     { MAC_ADDRESS_EMPTY, "Empty MAC address" },
     { MAC_ADDRESS_INVALID, "Invalid MAC address" },
+    { MAC_ADDRESS_OVERFLOW, "MAC address range exceeds FF-FF-FF-FF-FF-FF" },
     { FOLDER_PATH_DOESNT_EXIST, "Folder doesn't exist" },
     { FILE_PATH_DOESNT_EXIST, "File doesn't exist" },
     { FILE_CANT_READ, "File can't be read" },
     { FILE_CANT_WRITE, "File can't be written" },
     { EEPROM_WRONG_SIZE, "EEPROM has wrong size" },
     { EEPROM_INVALID_MAGIC, "EEPROM has invalid magic number" },
+    { EEPROM_VALUE_OUT_OF_RANGE, "Value can't be encoded in the EEPROM field" },
+    { CONTAINER_INVALID, "File is not a valid EEPROM container" },
+    { CONTAINER_MAC_NOT_FOUND, "MAC address not found in EEPROM container" },
+    { CONTAINER_DUPLICATE_MAC, "MAC address is contained more than once" },
+    { LOT_INVALID, "File is not a valid EEPROM lot" },
+    { LOT_IMAGE_MISMATCH, "EEPROM differs from the base of the lot in more than the MAC address" },
+    { LOT_IMAGE_NOT_FOUND, "Image not found in EEPROM lot" },
+    { LEDGER_INVALID, "File is not a valid MAC ledger" },
+    { LEDGER_INVALID_RANGE, "First MAC address of the ledger is greater than the last one" },
+    { LEDGER_EXHAUSTED, "All MAC addresses of the ledger are allocated" },
+    { SERVER_SOCKET_ERROR, "Socket can't be created" },
+    { SERVER_INVALID_REQUEST, "Request has invalid length" },
+    { SERVER_NO_TEMPLATE, "Request without template before the first template" },
+    { STREAM_INVALID_RECORD, "Record is not a JSON object" },
+    { STREAM_UNKNOWN_MEMBER, "Record has a member that is not part of EEPROM_CONFIG" },
+    { STREAM_INVALID_VALUE, "Record has a value of wrong type or out of range" },
+    { PROFILE_UNKNOWN, "Profile is neither built in nor a profile file" },
 };
 
 int error_type::code() const noexcept { return m_errnum; }
@@ -37,4 +55,19 @@ const char* error_type::what() const noexcept
     }
     return "No description, please add error code to ``errToStr``";
 }
+
+namespace {
+class ErrorCategory : public std::error_category
+{
+public:
+    const char* name() const noexcept override { return "lan7430conf"; }
+    std::string message(int errnum) const override { return error_type(errnum).what(); }
+};
+}  // namespace
+
+const std::error_category& error_category() noexcept
+{
+    static const ErrorCategory category;
+    return category;
+}
 }  // namespace ifm
@@ -10,44 +10,168 @@
 
 #include "lan7430conf/lan7430conf.hpp"
 
+#include "lan7430conf/eepromfile.hpp"
 #include "lan7430conf/errors.hpp"
+#include "lan7430conf/mac48.hpp"
 
 #include <spdlog/spdlog.h>
 
-#include <endian.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <filesystem>
 
 #include <cstring>
 #include <fstream>
-#include <regex>
+#include <utility>
 
 
-Mac stringToMac(const std::string& macString) noexcept(false)
+namespace {
+/// set for all characters that aren't hex digits
+constexpr Byte not_hex = 0x10;
+/// set for all characters that aren't a separator
+constexpr Byte not_separator = 0x20;
+
+/// value of the hex digit in the lower nibble plus the flags above, one lookup per character
+constexpr std::array<Byte, 256> makeMacCharTable() noexcept
+{
+    std::array<Byte, 256> table{};
+    for (size_t c = 0; c < table.size(); ++c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            table[c] = static_cast<Byte>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            table[c] = static_cast<Byte>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            table[c] = static_cast<Byte>(c - 'A' + 10);
+        }
+        else
+        {
+            table[c] = not_hex;
+        }
+        if (c != ':' && c != '-')
+        {
+            table[c] |= not_separator;
+        }
+    }
+    return table;
+}
+constexpr std::array<Byte, 256> mac_char_table = makeMacCharTable();
+
+/// both upper case hex digits of every byte value
+constexpr std::array<std::array<char, 2>, 256> makeHexTable() noexcept
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+    std::array<std::array<char, 2>, 256> table{};
+    for (size_t byte = 0; byte < table.size(); ++byte)
+    {
+        table[byte] = { digits[byte >> 4], digits[byte & 0x0f] };
+    }
+    return table;
+}
+constexpr std::array<std::array<char, 2>, 256> hex_table = makeHexTable();
+
+inline void formatMac(const Mac& mac, char* chars) noexcept
+{
+    for (size_t i = 0; i < mac.size(); ++i)
+    {
+        chars[3 * i] = hex_table[mac[i]][0];
+        chars[3 * i + 1] = hex_table[mac[i]][1];
+    }
+    for (size_t i = 2; i < mac_string_len; i += 3)
+    {
+        chars[i] = '-';
+    }
+}
+
+/**
+ * @brief parses the 17 characters XX:XX:XX:XX:XX:XX (any mix of ':' and '-')
+ * There is no early exit, the flags of all characters are or'ed together and checked once.
+ */
+inline bool parseMacChars(const char* chars, Mac& mac) noexcept
+{
+    Byte invalid = 0;
+    for (size_t i = 0; i < mac.size(); ++i)
+    {
+        const Byte high = mac_char_table[static_cast<unsigned char>(chars[3 * i])];
+        const Byte low = mac_char_table[static_cast<unsigned char>(chars[3 * i + 1])];
+        invalid |= (high | low) & not_hex;
+        mac[i] = static_cast<Byte>((high & 0x0f) << 4 | (low & 0x0f));
+    }
+    for (size_t i = 2; i < mac_string_len; i += 3)
+    {
+        invalid |= mac_char_table[static_cast<unsigned char>(chars[i])] & not_separator;
+    }
+    return invalid == 0;
+}
+}  // namespace
+
+std::error_code parseMac(std::string_view macString, Mac& mac) noexcept
 {
     if (macString.empty())
     {
-        throw ifm::error_type(ifm::MAC_ADDRESS_EMPTY);
+        return ifm::make_error_code(ifm::MAC_ADDRESS_EMPTY);
+    }
+    Mac parsed;
+    if (macString.size() != mac_string_len || !parseMacChars(macString.data(), parsed))
+    {
+        return ifm::make_error_code(ifm::MAC_ADDRESS_INVALID);
     }
-    std::regex rx(
-        R"(^(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])([0-9A-Fa-f]{2})$)",
-        std::regex::icase);
-    std::smatch match;
+    mac = parsed;
+    return {};
+}
 
-    if (!std::regex_match(macString, match, rx))
+size_t parseMacs(const std::vector<std::string_view>& macStrings,
+                 std::vector<Mac>& macs,
+                 std::vector<std::error_code>& errors) noexcept(false)
+{
+    macs.assign(macStrings.size(), Mac{});
+    errors.assign(macStrings.size(), std::error_code{});
+    size_t invalid = 0;
+    for (size_t i = 0; i < macStrings.size(); ++i)
     {
-        throw ifm::error_type(ifm::MAC_ADDRESS_INVALID);
+        if (const std::error_code error = parseMac(macStrings[i], macs[i]))
+        {
+            errors[i] = error;
+            ++invalid;
+        }
     }
+    return invalid;
+}
 
+Mac stringToMac(const std::string& macString) noexcept(false)
+{
     Mac mac;
-    for (size_t i = 1; i < match.size(); i++)
+    if (const std::error_code error = parseMac(macString, mac))
     {
-        mac[i - 1] = static_cast<Byte>(std::stoul(match[i].str(), nullptr, 16));
+        throw ifm::error_type(error.value());
     }
-
     return mac;
 }
 
-std::string macToString(const Mac& mac) { return fmt::format("{:02X}", fmt::join(mac, "-")); }
+std::string macToString(const Mac& mac)
+{
+    char chars[mac_string_len];
+    formatMac(mac, chars);
+    return std::string(chars, sizeof(chars));
+}
+
+void macToChars(const Mac& mac, char (&chars)[mac_string_len]) noexcept { formatMac(mac, chars); }
+
+void macsToChars(const Mac* macs, size_t count, char* buffer, size_t stride) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        formatMac(macs[i], buffer + i * stride);
+    }
+}
+
+Mac incrementMac(const Mac& mac, uint64_t offset) noexcept(false) { return Mac48(mac) + offset; }
 
 LAN7430_CONFIG_LIB_EXPORT bool validateMAC(const Mac& macArray)
 {
@@ -60,218 +184,124 @@ LAN7430_CONFIG_LIB_EXPORT bool validateMAC(const Mac& macArray)
     return valid;
 }
 
-void validateEEPROM(const EEPROM& eeprom) noexcept(false)
+void setCommonModeRestoreTime(EEPROM_CONFIG& config, uint32_t microSeconds) noexcept(false)
 {
-    std::vector<EEPROM_MAGIC> magic{ EEPROM_MAGIC::EEPROM,
-                                     EEPROM_MAGIC::EEPROM_MAC,
-                                     EEPROM_MAGIC::EEPROM_OTP1,
-                                     EEPROM_MAGIC::EEPROM_OTP2 };
-    if (std::none_of(magic.begin(), magic.end(), [&](EEPROM_MAGIC m) {
+    if (microSeconds > common_mode_restore_time_max)
+    {
+        throw ifm::error_type(ifm::EEPROM_VALUE_OUT_OF_RANGE);
+    }
+    config.commonModeRestoreTime = static_cast<Byte>(microSeconds);
+}
+
+void setTPowerOn(EEPROM_CONFIG& config, uint32_t microSeconds) noexcept(false)
+{
+    if (microSeconds > t_power_on_max)
+    {
+        throw ifm::error_type(ifm::EEPROM_VALUE_OUT_OF_RANGE);
+    }
+    // every scale is a multiple of the smaller ones, the first one the value fits is the tightest
+    constexpr std::pair<T_POWER_ON_SCALE, uint32_t> scales[]{
+        { T_POWER_ON_SCALE::MICRO_SECONDS_2, 2 },
+        { T_POWER_ON_SCALE::MICRO_SECONDS_10, 10 },
+        { T_POWER_ON_SCALE::MICRO_SECONDS_100, 100 },
+    };
+    for (const auto& [scale, unit] : scales)
+    {
+        const uint32_t value = (microSeconds + unit - 1) / unit;
+        if (value <= bitmask<Byte, 0, 4>())
+        {
+            config.tPowerOnScale = scale;
+            config.tPowerOnValue = static_cast<Byte>(value);
+            return;
+        }
+    }
+}
+
+namespace {
+std::error_code checkEEPROM(const EEPROM& eeprom) noexcept
+{
+    constexpr EEPROM_MAGIC magic[]{ EEPROM_MAGIC::EEPROM,
+                                    EEPROM_MAGIC::EEPROM_MAC,
+                                    EEPROM_MAGIC::EEPROM_OTP1,
+                                    EEPROM_MAGIC::EEPROM_OTP2 };
+    if (std::none_of(std::begin(magic), std::end(magic), [&](EEPROM_MAGIC m) {
             return m == EEPROM_MAGIC(eeprom.magic);
         }))
     {
-        throw ifm::error_type(ifm::EEPROM_INVALID_MAGIC);
+        return ifm::make_error_code(ifm::EEPROM_INVALID_MAGIC);
     }
 
     if (!validateMAC(eeprom.mac))
     {
-        throw ifm::error_type(ifm::MAC_ADDRESS_INVALID);
+        return ifm::make_error_code(ifm::MAC_ADDRESS_INVALID);
     }
 
     // TODO: add more validation steps e.g. values are in valid range
+    return {};
 }
 
-EEPROM_CONFIG eepromConfigToEEPROM(EEPROM eeprom) noexcept(false)
+EEPROM toEEPROM(const EepromBytes& bytes) noexcept
 {
-    EEPROM_CONFIG config{};
-
-    config.magic = EEPROM_MAGIC(eeprom.magic);
-    config.mac = eeprom.mac;
-
-    config.clockPowerManagement = getBit<bool>(eeprom.deviceCapabilitiesEnable_1_2, 3);
-    config.ltrMechanismSupport = getBit<bool>(eeprom.deviceCapabilitiesEnable_1_2, 7);
-
-    config.aspmL1EntryControl = getBit<ASPM_L1_ENTRY_CONTROL>(eeprom.aspmConfigEnable, 4);
-
-    config.subsystemVendorID = eeprom.subsystemVendorID;
-    config.subsystemID = eeprom.subsystemID;
-
-    config.auxCurrent = getBitmask<AUX_CURRENT>(eeprom.powerManagementCapabilities, 0, 2);
-    config.pmeSupport = getBitmask<PME_SUPPORT>(eeprom.powerManagementCapabilities, 3, 7);
-
-    config.clockPowerManagement = getBit<bool>(eeprom.deviceCapabilities_1, 7);
-
-    config.ltrMechanismSupport = getBit<bool>(eeprom.deviceCapabilities_2, 1);
-    config.obffSupport = getBitmask<OBFF_SUPPORT>(eeprom.powerManagementCapabilities, 2, 3);
-
-    config.pciPML12Support = getBit<bool>(eeprom.l1PMSubstatesCapabilitesEnable, 2);
-    config.pciPML11Support = getBit<bool>(eeprom.l1PMSubstatesCapabilitesEnable, 3);
-    config.aspmL12Support = getBit<bool>(eeprom.l1PMSubstatesCapabilitesEnable, 4);
-    config.aspmL11Support = getBit<bool>(eeprom.l1PMSubstatesCapabilitesEnable, 5);
-    config.l1PMSubstatesSupported = getBit<bool>(eeprom.l1PMSubstatesCapabilitesEnable, 6);
-
-    config.aspmL0EntranceLatency = getBitmask<ASPM_L0_ENTRANCE_LATENCY>(eeprom.aspmConfig, 0, 2);
-    config.aspmL1EntranceLatency = getBitmask<ASPM_L1_ENTRANCE_LATENCY>(eeprom.aspmConfig, 4, 6);
-    config.aspmL1EntryControl = getBit<ASPM_L1_ENTRY_CONTROL>(eeprom.aspmConfig, 7);
-
-    config.macConfiguration = getBitmask<MAC_CONFIGURATION>(eeprom.macConfig1, 0, 1);
-    config.duplexMode = getBit<DUPLEX_MODE>(eeprom.macConfig1, 2);
-    config.automaticSpeedDetection = getBit<bool>(eeprom.macConfig1, 3);
-    config.automaticDuplexDetection = getBit<bool>(eeprom.macConfig1, 4);
-    config.automaticDuplexPolarity = getBit<AUTOMATIC_DUPLEX_POLARITY>(eeprom.macConfig1, 5);
-    config.energyEfficientEthernet = getBit<bool>(eeprom.macConfig1, 7);
-
-    config.energyEfficientEthernetTxClockStop = getBit<bool>(eeprom.macConfig1, 0);
-
-    config.ledConfig[0].enable = getBit<bool>(eeprom.ledConfig1, 0);
-    config.ledConfig[0].polarity = getBit<LED_POLARITY>(eeprom.ledConfig1, 4);
-
-    config.ledConfig[1].enable = getBit<bool>(eeprom.ledConfig1, 1);
-    config.ledConfig[1].polarity = getBit<LED_POLARITY>(eeprom.ledConfig1, 5);
-
-    config.ledConfig[2].enable = getBit<bool>(eeprom.ledConfig1, 2);
-    config.ledConfig[2].polarity = getBit<LED_POLARITY>(eeprom.ledConfig1, 6);
-
-    config.ledConfig[3].enable = getBit<bool>(eeprom.ledConfig1, 3);
-    config.ledConfig[3].polarity = getBit<LED_POLARITY>(eeprom.ledConfig1, 7);
+    EEPROM eeprom;
+    std::memcpy(&eeprom, bytes.data(), sizeof(EEPROM));
+    return eeprom;
+}
+}  // namespace
 
-    eeprom.ledConfig2 = be16toh(eeprom.ledConfig2);
-    config.ledConfig[0].control = getBitmask<LED_CONTROL>(eeprom.ledConfig2, 0, 3);
-    config.ledConfig[1].control = getBitmask<LED_CONTROL>(eeprom.ledConfig2, 4, 7);
-    config.ledConfig[2].control = getBitmask<LED_CONTROL>(eeprom.ledConfig2, 8, 11);
-    config.ledConfig[3].control = getBitmask<LED_CONTROL>(eeprom.ledConfig2, 12, 15);
+std::error_code validateEEPROM(const EepromBytes& bytes) noexcept
+{
+    return checkEEPROM(toEEPROM(bytes));
+}
 
-    eeprom.ledConfig3 = be16toh(eeprom.ledConfig3);
-    config.ledConfig[0].combineFeature = getBit<LED_COMBINE>(eeprom.ledConfig3, 0);
-    config.ledConfig[1].combineFeature = getBit<LED_COMBINE>(eeprom.ledConfig3, 1);
-    config.ledConfig[2].combineFeature = getBit<LED_COMBINE>(eeprom.ledConfig3, 2);
-    config.ledConfig[3].combineFeature = getBit<LED_COMBINE>(eeprom.ledConfig3, 3);
+void validateEEPROM(const EEPROM& eeprom) noexcept(false)
+{
+    EepromBytes bytes;
+    std::memcpy(bytes.data(), &eeprom, sizeof(EEPROM));
+    if (const auto error = validateEEPROM(bytes))
+    {
+        throw ifm::error_type(error.value());
+    }
+}
 
-    config.ledConfig[0].blinkPulseStretch = getBit<LED_BLINK_PULSE_STRETCH>(eeprom.ledConfig3, 5);
-    config.ledConfig[1].blinkPulseStretch = getBit<LED_BLINK_PULSE_STRETCH>(eeprom.ledConfig3, 6);
-    config.ledConfig[2].blinkPulseStretch = getBit<LED_BLINK_PULSE_STRETCH>(eeprom.ledConfig3, 7);
-    config.ledConfig[3].blinkPulseStretch = getBit<LED_BLINK_PULSE_STRETCH>(eeprom.ledConfig3, 8);
+std::error_code encodeEEPROM(const EEPROM_CONFIG& config, EepromBytes& bytes) noexcept
+{
+    const EEPROM eeprom = createEEPROMConstexpr(config);
+    if (const auto error = checkEEPROM(eeprom))
+    {
+        return error;
+    }
+    std::memcpy(bytes.data(), &eeprom, sizeof(EEPROM));
+    return {};
+}
 
-    config.blinkPulseStretchRate = getBitmask<BLINK_PULSE_STRETCH_RATE>(eeprom.ledConfig3, 10, 11);
-    config.ledPulsing = getBit<LED_PULSING>(eeprom.ledConfig3, 12);
-    config.ledActivityOutput = getBit<LED_ACTIVITY_OUTPUT>(eeprom.ledConfig3, 14);
+std::error_code decodeEEPROM(const EepromBytes& bytes, EEPROM_CONFIG& config) noexcept
+{
+    const EEPROM eeprom = toEEPROM(bytes);
+    if (const auto error = checkEEPROM(eeprom))
+    {
+        return error;
+    }
+    config = eepromConfigToEEPROMConstexpr(eeprom);
+    return {};
+}
 
-    return config;
+EEPROM_CONFIG eepromConfigToEEPROM(EEPROM eeprom) noexcept(false)
+{
+    return eepromConfigToEEPROMConstexpr(eeprom);
 }
 
 EEPROM createEEPROM(const EEPROM_CONFIG& conf) noexcept(false)
 {
-    std::array<Byte, base_eeprom_len> eeprom_bin{};
-    std::copy(std::begin(base_eeprom), std::end(base_eeprom), eeprom_bin.begin());
-
-    EEPROM eeprom{};
-
-
-    eeprom.magic = static_cast<Byte>(conf.magic);
-    eeprom.mac = conf.mac;
-
-    setBit<Byte>(eeprom.byte7, 2, conf.auxCurrent != AUX_CURRENT::AC_0);
-    setBit<Byte>(eeprom.byte7, 3, conf.pmeSupport != PME_SUPPORT::NONE);
-
-    setBit<Byte>(eeprom.deviceCapabilitiesEnable_1_2, 3, conf.clockPowerManagement);
-    setBit<Byte>(eeprom.deviceCapabilitiesEnable_1_2, 7, conf.ltrMechanismSupport);
-
-    setBit<Byte>(
-        eeprom.l1PMSubstatesCapabilitesEnable, 0, conf.obffSupport != OBFF_SUPPORT::NOT_SUPPORTED);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilitesEnable, 2, conf.pciPML12Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilitesEnable, 3, conf.pciPML11Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilitesEnable, 4, conf.aspmL12Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilitesEnable, 5, conf.aspmL11Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilitesEnable, 6, conf.l1PMSubstatesSupported);
-
-    setBit<Byte>(eeprom.byte7, 0, conf.subsystemVendorID != 0x0);
-    setBit<Byte>(eeprom.byte7, 1, conf.subsystemID != 0x0);
-
-    setBit<Byte>(eeprom.aspmConfigEnable,
-                 2,
-                 conf.aspmL0EntranceLatency != ASPM_L0_ENTRANCE_LATENCY::MICRO_SECONDS_1);
-    setBit<Byte>(eeprom.aspmConfigEnable,
-                 3,
-                 conf.aspmL1EntranceLatency != ASPM_L1_ENTRANCE_LATENCY::MICRO_SECONDS_1);
-
-    setBit<Byte>(eeprom.aspmConfigEnable, 4, static_cast<Byte>(conf.aspmL1EntryControl));
-
-    eeprom.subsystemVendorID = conf.subsystemVendorID;
-    eeprom.subsystemID = conf.subsystemID;
-
-    setBitmask<Byte>(eeprom.powerManagementCapabilities, 0, 2, static_cast<Byte>(conf.auxCurrent));
-    setBitmask<Byte>(eeprom.powerManagementCapabilities, 3, 7, static_cast<Byte>(conf.pmeSupport));
-
-    setBit<Byte>(eeprom.deviceCapabilities_1, 7, conf.clockPowerManagement);
-
-    setBit<Byte>(eeprom.deviceCapabilities_2, 1, conf.ltrMechanismSupport);
-    setBitmask<Byte>(eeprom.deviceCapabilities_2, 2, 3, static_cast<Byte>(conf.obffSupport));
-
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilites, 0, conf.pciPML12Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilites, 1, conf.pciPML11Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilites, 2, conf.aspmL12Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilites, 3, conf.aspmL11Support);
-    setBit<Byte>(eeprom.l1PMSubstatesCapabilites, 4, conf.l1PMSubstatesSupported);
-
-    setBitmask<Byte>(eeprom.aspmConfig, 0, 2, static_cast<Byte>(conf.aspmL0EntranceLatency));
-    setBitmask<Byte>(eeprom.aspmConfig, 4, 6, static_cast<Byte>(conf.aspmL1EntranceLatency));
-    setBit<Byte>(eeprom.aspmConfig, 7, static_cast<Byte>(conf.aspmL1EntryControl));
-
-    setBitmask<Byte>(eeprom.macConfig1, 0, 1, static_cast<Byte>(conf.macConfiguration));
-    setBit<Byte>(eeprom.macConfig1, 2, static_cast<Byte>(conf.duplexMode));
-    setBit<Byte>(eeprom.macConfig1, 3, conf.automaticSpeedDetection);
-    setBit<Byte>(eeprom.macConfig1, 4, conf.automaticDuplexDetection);
-    setBit<Byte>(eeprom.macConfig1, 5, static_cast<Byte>(conf.automaticDuplexPolarity));
-    setBit<Byte>(eeprom.macConfig1, 7, conf.energyEfficientEthernet);
-
-    setBit<Byte>(eeprom.macConfig2, 0, conf.energyEfficientEthernetTxClockStop);
-
-    setBit<Byte>(eeprom.ledConfig1, 0, conf.ledConfig[0].enable);
-    setBit<Byte>(eeprom.ledConfig1, 4, static_cast<Byte>(conf.ledConfig[0].polarity));
-
-    setBit<Byte>(eeprom.ledConfig1, 1, conf.ledConfig[1].enable);
-    setBit<Byte>(eeprom.ledConfig1, 5, static_cast<Byte>(conf.ledConfig[1].polarity));
-
-    setBit<Byte>(eeprom.ledConfig1, 2, conf.ledConfig[2].enable);
-    setBit<Byte>(eeprom.ledConfig1, 6, static_cast<Byte>(conf.ledConfig[2].polarity));
-
-    setBit<Byte>(eeprom.ledConfig1, 3, conf.ledConfig[3].enable);
-    setBit<Byte>(eeprom.ledConfig1, 7, static_cast<Byte>(conf.ledConfig[3].polarity));
-
-    setBitmask<Byte16>(eeprom.ledConfig2, 0, 3, static_cast<Byte>(conf.ledConfig[0].control));
-    setBitmask<Byte16>(eeprom.ledConfig2, 4, 7, static_cast<Byte>(conf.ledConfig[1].control));
-    setBitmask<Byte16>(eeprom.ledConfig2, 8, 11, static_cast<Byte>(conf.ledConfig[2].control));
-    setBitmask<Byte16>(eeprom.ledConfig2, 12, 15, static_cast<Byte>(conf.ledConfig[3].control));
-
-    eeprom.ledConfig2 = be16toh(eeprom.ledConfig2);
-
-    setBit<Byte16>(eeprom.ledConfig3, 0, static_cast<Byte>(conf.ledConfig[0].combineFeature));
-    setBit<Byte16>(eeprom.ledConfig3, 1, static_cast<Byte>(conf.ledConfig[1].combineFeature));
-    setBit<Byte16>(eeprom.ledConfig3, 2, static_cast<Byte>(conf.ledConfig[2].combineFeature));
-    setBit<Byte16>(eeprom.ledConfig3, 3, static_cast<Byte>(conf.ledConfig[3].combineFeature));
-
-    setBit<Byte16>(eeprom.ledConfig3, 5, static_cast<Byte>(conf.ledConfig[0].blinkPulseStretch));
-    setBit<Byte16>(eeprom.ledConfig3, 6, static_cast<Byte>(conf.ledConfig[1].blinkPulseStretch));
-    setBit<Byte16>(eeprom.ledConfig3, 7, static_cast<Byte>(conf.ledConfig[2].blinkPulseStretch));
-    setBit<Byte16>(eeprom.ledConfig3, 8, static_cast<Byte>(conf.ledConfig[3].blinkPulseStretch));
-
-    setBitmask<Byte16>(eeprom.ledConfig3, 10, 11, static_cast<Byte>(conf.blinkPulseStretchRate));
-    setBit<Byte16>(eeprom.ledConfig3, 12, static_cast<Byte16>(conf.ledPulsing));
-    setBit<Byte16>(eeprom.ledConfig3, 14, static_cast<Byte16>(conf.ledActivityOutput));
-
-    eeprom.ledConfig3 = be16toh(eeprom.ledConfig3);
-
-    std::copy(std::begin(base_eeprom) + eeprom_user_defined_size,
-              std::end(base_eeprom),
-              eeprom.base_config.begin());  // copy the remaining base eeprom to the array
-
-    return eeprom;
+    return createEEPROMConstexpr(conf);
 }
 
 void writeEEPROM(const std::string& filePath, const EEPROM_CONFIG& config) noexcept(false)
 {
-    EEPROM eeprom = createEEPROM(config);
+    writeRawEEPROM(filePath, createEEPROM(config));
+}
 
+void writeRawEEPROM(const std::string& filePath, const EEPROM& eeprom) noexcept(false)
+{
     std::filesystem::path path(filePath);
     if (path.has_parent_path() && !std::filesystem::exists(path.remove_filename()))
     {
@@ -284,7 +314,7 @@ void writeEEPROM(const std::string& filePath, const EEPROM_CONFIG& config) noexc
         throw ifm::error_type(ifm::FILE_CANT_WRITE);
     }
 
-    out.write(reinterpret_cast<char*>(&eeprom), sizeof(EEPROM));
+    out.write(reinterpret_cast<const char*>(&eeprom), sizeof(EEPROM));
     out.close();
     if (!out)
     {
@@ -292,33 +322,31 @@ void writeEEPROM(const std::string& filePath, const EEPROM_CONFIG& config) noexc
     }
 }
 
-EEPROM readEEPROM(const std::string& filePath) noexcept(false)
+void replaceEEPROM(const std::string& filePath, const EEPROM& eeprom) noexcept(false)
 {
-    if (filePath.empty() || !std::filesystem::exists(filePath))
+    std::filesystem::path path(filePath);
+    if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
     {
-        throw ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST);
+        throw ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST);
     }
 
-    if (std::filesystem::file_size(filePath) != 255
-        && std::filesystem::file_size(filePath)
-               != 512)  // NOTE(MA): the gui (MPLAB Connect) seems to create only files of size
-                        // 255... even if specified to use 512
+    const std::string tempPath = filePath + "." + std::to_string(::getpid()) + ".tmp";
+    const int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if (fd < 0)
     {
-        throw ifm::error_type(ifm::EEPROM_WRONG_SIZE);
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
     }
-
-    std::ifstream in(filePath, std::ios::binary | std::ios::in);
-
-    if (!in)
+    const ssize_t written = ::write(fd, &eeprom, sizeof(EEPROM));
+    const bool synced = ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !synced || written != static_cast<ssize_t>(sizeof(EEPROM))
+        || ::rename(tempPath.c_str(), filePath.c_str()) != 0)
     {
-        throw ifm::error_type(ifm::FILE_CANT_READ);
+        ::unlink(tempPath.c_str());
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
     }
+}
 
-    EEPROM eeprom;
-    in.read((char*) &eeprom, sizeof(EEPROM));
-    in.close();
-
-    validateEEPROM(eeprom);
-
-    return eeprom;
+EEPROM readEEPROM(const std::string& filePath) noexcept(false)
+{
+    return EepromFile(filePath).eeprom();
 }
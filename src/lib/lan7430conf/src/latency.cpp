@@ -0,0 +1,363 @@
+/** @file latency.cpp
+ *
+ *  @brief contains functions to estimate the wake-up latency caused by the power management
+ *  settings of EEPROM images, without installing the images on a board
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/latency.hpp"
+
+#include "lan7430conf/container.hpp"
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+constexpr uint64_t ns_per_us = 1000;
+
+// indexed by the raw value of the field, see doc/layout.txt
+constexpr uint64_t l0s_latency[]{ 64, 128, 256, 512, 1000, 2000, 4000, latency_unbounded };
+constexpr uint64_t l1_latency[]{ 1000, 2000, 4000, 8000, 16000, 32000, 64000, latency_unbounded };
+
+// Tw_sys_tx of IEEE 802.3az, 10BASE-Te has no LPI
+constexpr uint64_t eee_wake_100 = 30000;
+constexpr uint64_t eee_wake_1000 = 16500;
+
+uint64_t saturatingAdd(uint64_t a, uint64_t b) noexcept
+{
+    return a > latency_unbounded - b ? latency_unbounded : a + b;
+}
+
+template<size_t N, typename T>
+uint64_t lookup(const uint64_t (&table)[N], T value) noexcept
+{
+    return table[static_cast<size_t>(value) % N];
+}
+
+/// the settings of two images are equal, i.e. everything but the MAC address
+bool sameSettings(const EEPROM& a, const EEPROM& b) noexcept
+{
+    constexpr size_t settingsOffset = offsetof(EEPROM, byte7);
+    return std::memcmp(reinterpret_cast<const Byte*>(&a) + settingsOffset,
+                       reinterpret_cast<const Byte*>(&b) + settingsOffset,
+                       sizeof(EEPROM) - settingsOffset)
+           == 0;
+}
+
+struct FileResult
+{
+    bool skipped{ false };
+    std::vector<LatencyReport> reports;
+};
+
+FileResult analyzeFile(const std::string& filePath, const LatencyBudget& budget)
+{
+    FileResult result;
+    // returns the report the images were added to
+    const auto add = [&](const EEPROM& eeprom, uint64_t images) -> LatencyReport& {
+        LatencyFigures figures = latencyFigures(eeprom);
+        for (auto& report : result.reports)
+        {
+            if (report.figures == figures)
+            {
+                report.images += images;
+                return report;
+            }
+        }
+        std::vector<std::string> violations = checkLatencyBudget(figures, budget);
+        result.reports.push_back(
+            { filePath, images, std::move(figures), std::move(violations) });
+        return result.reports.back();
+    };
+
+    try
+    {
+        if (EepromContainer::isContainer(filePath))
+        {
+            const EepromContainer container(filePath);
+            // the images of a container usually share their settings, decode only on a change
+            const EEPROM* previous = nullptr;
+            LatencyReport* report = nullptr;
+            for (uint64_t i = 0; i < container.size(); ++i)
+            {
+                const EEPROM& image = container.imageAt(i);
+                if (previous != nullptr && sameSettings(*previous, image))
+                {
+                    ++report->images;
+                }
+                else
+                {
+                    report = &add(image, 1);
+                }
+                previous = &image;
+            }
+        }
+        else if (EepromLot::isLot(filePath))
+        {
+            const EepromLot lot = readEEPROMLot(filePath);
+            add(lot.base(), lot.size());
+        }
+        else
+        {
+            add(readEEPROM(filePath), 1);
+        }
+    }
+    catch (const ifm::error_type&)
+    {
+        result.skipped = true;
+        result.reports.clear();
+    }
+    return result;
+}
+
+}  // namespace
+
+bool LatencyFigures::operator==(const LatencyFigures& other) const noexcept
+{
+    return l0sEntrance == other.l0sEntrance && l1Entrance == other.l1Entrance
+           && l0sAcceptable == other.l0sAcceptable && l1Acceptable == other.l1Acceptable
+           && l0sExit == other.l0sExit && l1Exit == other.l1Exit
+           && l0sBlocked == other.l0sBlocked && l1Blocked == other.l1Blocked
+           && l12Enabled == other.l12Enabled && l12Exit == other.l12Exit
+           && eeeWake == other.eeeWake && worstWake == other.worstWake
+           && defaults == other.defaults;
+}
+
+LatencyFigures latencyFigures(const EEPROM& eeprom)
+{
+    const EEPROM_CONFIG config = eepromConfigToEEPROM(eeprom);
+    const EepromView view(eeprom);
+
+    LatencyFigures figures;
+    figures.l0sEntrance = (static_cast<uint64_t>(config.aspmL0EntranceLatency) + 1) * ns_per_us;
+    figures.l1Entrance = (uint64_t{ 1 } << static_cast<uint32_t>(config.aspmL1EntranceLatency))
+                         * ns_per_us;
+    figures.l0sAcceptable = lookup(l0s_latency, config.l0sAcceptableLatency);
+    figures.l1Acceptable = lookup(l1_latency, config.l1AcceptableLatency);
+    figures.l0sExit = lookup(l0s_latency, config.l0sExitLatency);
+    figures.l1Exit = lookup(l1_latency, config.l1ExitLatency);
+    figures.l0sBlocked = figures.l0sExit > figures.l0sAcceptable;
+    figures.l1Blocked = figures.l1Exit > figures.l1Acceptable;
+
+    // a capability whose override bit is cleared keeps the hardware default, which may support it
+    const auto mayBeSupported = [&](const auto& field) {
+        return !view.enabled(field) || view.get(field);
+    };
+    figures.l12Enabled = mayBeSupported(fields::l1PMSubstatesSupported)
+                         && (mayBeSupported(fields::aspmL12Support)
+                             || mayBeSupported(fields::pciPML12Support));
+    if (figures.l12Enabled)
+    {
+        figures.l12Exit = saturatingAdd(figures.l1Exit, l12ExitMicroSeconds(config) * ns_per_us);
+    }
+
+    if (config.energyEfficientEthernet)
+    {
+        // with automatic speed detection the link may come up with 100 Mbps, which wakes slowest
+        if (config.automaticSpeedDetection
+            || config.macConfiguration == MAC_CONFIGURATION::MPBS_100)
+        {
+            figures.eeeWake = eee_wake_100;
+        }
+        else if (config.macConfiguration != MAC_CONFIGURATION::MPBS_10)
+        {
+            figures.eeeWake = eee_wake_1000;
+        }
+    }
+
+    uint64_t linkExit = 0;
+    if (!figures.l0sBlocked)
+    {
+        linkExit = figures.l0sExit;
+    }
+    if (!figures.l1Blocked)
+    {
+        linkExit = std::max(linkExit, figures.l12Enabled ? figures.l12Exit : figures.l1Exit);
+    }
+    figures.worstWake = saturatingAdd(linkExit, figures.eeeWake);
+
+    const auto keepsDefault = [&](const auto& field) {
+        if (!view.enabled(field))
+        {
+            figures.defaults.push_back(field.name);
+        }
+    };
+    keepsDefault(fields::l0sAcceptableLatency);
+    keepsDefault(fields::l1AcceptableLatency);
+    keepsDefault(fields::l0sExitLatency);
+    keepsDefault(fields::l1ExitLatency);
+    keepsDefault(fields::clockPowerManagement);
+    keepsDefault(fields::ltrMechanismSupport);
+    keepsDefault(fields::pciPML12Support);
+    keepsDefault(fields::pciPML11Support);
+    keepsDefault(fields::aspmL12Support);
+    keepsDefault(fields::aspmL11Support);
+    keepsDefault(fields::l1PMSubstatesSupported);
+    if (figures.l12Enabled)
+    {
+        keepsDefault(fields::commonModeRestoreTime);
+        keepsDefault(fields::tPowerOnValue);
+    }
+    return figures;
+}
+
+std::vector<std::string> checkLatencyBudget(const LatencyFigures& figures,
+                                            const LatencyBudget& budget)
+{
+    std::vector<std::string> violations;
+    if (!figures.l0sBlocked && figures.l0sExit > budget.l0sExit)
+    {
+        violations.emplace_back("l0sExit");
+    }
+    if (!figures.l1Blocked && figures.l1Exit > budget.l1Exit)
+    {
+        violations.emplace_back("l1Exit");
+    }
+    if (!figures.l1Blocked && figures.l12Enabled && figures.l12Exit > budget.l12Exit)
+    {
+        violations.emplace_back("l12Exit");
+    }
+    if (figures.eeeWake > budget.eeeWake)
+    {
+        violations.emplace_back("eeeWake");
+    }
+    if (figures.worstWake > budget.worstWake)
+    {
+        violations.emplace_back("worstWake");
+    }
+    if (budget.strict && !figures.defaults.empty())
+    {
+        violations.emplace_back("defaults");
+    }
+    return violations;
+}
+
+std::string latencyToString(uint64_t nanoSeconds)
+{
+    if (nanoSeconds == latency_unbounded)
+    {
+        return "unbounded";
+    }
+    if (nanoSeconds < ns_per_us)
+    {
+        return std::to_string(nanoSeconds) + "ns";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%gus", double(nanoSeconds) / ns_per_us);
+    return buffer;
+}
+
+LatencyAnalysis analyzeLatency(const std::vector<std::string>& paths,
+                               const LatencyBudget& budget,
+                               unsigned int threads) noexcept(false)
+{
+    std::vector<std::string> files;
+    for (const auto& path : paths)
+    {
+        if (!std::filesystem::exists(path))
+        {
+            throw ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST);
+        }
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file())
+                {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            files.push_back(path);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(
+        std::max<size_t>(1, std::min<size_t>(threads, files.size())));
+
+    // every file has its own slot, so the workers don't share anything but the counter
+    std::atomic<size_t> next{ 0 };
+    std::vector<FileResult> results(files.size());
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    try
+    {
+        for (unsigned int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                try
+                {
+                    for (size_t i = next++; i < files.size(); i = next++)
+                    {
+                        results[i] = analyzeFile(files[i], budget);
+                    }
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+    }
+    catch (...)
+    {
+        // a thread couldn't be started, the running workers stop after their current file
+        next = files.size();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    LatencyAnalysis analysis;
+    analysis.files = files.size();
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (results[i].skipped)
+        {
+            analysis.skipped.push_back(files[i]);
+            continue;
+        }
+        for (auto& report : results[i].reports)
+        {
+            analysis.images += report.images;
+            if (!report.violations.empty())
+            {
+                analysis.violations += report.images;
+            }
+            analysis.reports.push_back(std::move(report));
+        }
+    }
+    return analysis;
+}
@@ -0,0 +1,174 @@
+/** @file ledger.cpp
+ *
+ *  @brief contains a crash-safe MAC address allocator shared between processes
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/ledger.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static_assert(__atomic_always_lock_free(sizeof(uint64_t), 0),
+              "the ledger needs lock-free 64 bit atomics");
+static_assert(sizeof(MAC_LEDGER_HEADER) == 64 && offsetof(MAC_LEDGER_HEADER, next) == 0x20,
+              "unexpected ledger header layout");
+
+void MacLedger::create(const std::string& filePath, const Mac& first, const Mac& last) noexcept(
+    false)
+{
+    const MacRange range = MacRange::closed(first, last);
+    if (range.empty())
+    {
+        throw ifm::error_type(ifm::LEDGER_INVALID_RANGE);
+    }
+
+    MAC_LEDGER_HEADER header{};
+    std::memcpy(header.magic, mac_ledger_magic, sizeof(header.magic));
+    header.version = mac_ledger_version;
+    header.first = range.first().value();
+    header.last = range.last().value();
+    header.next = header.first;
+
+    const int fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    const ssize_t written = ::write(fd, &header, sizeof(header));
+    const bool synced = ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !synced || written != static_cast<ssize_t>(sizeof(header)))
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+
+    // a journal left over from a former ledger at the same path doesn't belong to this range
+    std::ofstream journal(journalPath(filePath), std::ios::binary | std::ios::trunc);
+    if (!journal)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+}
+
+MacLedger::MacLedger(const std::string& filePath) noexcept(false)
+: m_file(filePath, MappedFile::Mode::READ_WRITE)
+{
+    if (m_file.size() < sizeof(MAC_LEDGER_HEADER)
+        || std::memcmp(header()->magic, mac_ledger_magic, sizeof(mac_ledger_magic)) != 0
+        || header()->version != mac_ledger_version || header()->first > header()->last)
+    {
+        throw ifm::error_type(ifm::LEDGER_INVALID);
+    }
+
+    m_journal = ::open(
+        journalPath(filePath).c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_journal < 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    try
+    {
+        recover();
+    }
+    catch (...)
+    {
+        ::close(m_journal);
+        throw;
+    }
+}
+
+MacLedger::~MacLedger()
+{
+    if (m_journal >= 0)
+    {
+        ::close(m_journal);
+    }
+}
+
+void MacLedger::recover() noexcept(false)
+{
+    const off_t size = ::lseek(m_journal, 0, SEEK_END);
+    if (size < 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    // a torn record at the end was never handed out, it is ignored
+    std::vector<uint64_t> records(static_cast<size_t>(size) / sizeof(uint64_t));
+    const ssize_t bytes = records.size() * sizeof(uint64_t);
+    if (::pread(m_journal, records.data(), bytes, 0) != bytes)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    uint64_t next = header()->first;
+    for (const auto& record : records)
+    {
+        next = std::max(next, record + 1);
+    }
+
+    uint64_t current = __atomic_load_n(&header()->next, __ATOMIC_SEQ_CST);
+    while (current < next
+           && !__atomic_compare_exchange_n(
+               &header()->next, &current, next, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+    }
+    if (current < next)
+    {
+        m_file.sync();
+    }
+}
+
+Mac MacLedger::allocate() noexcept(false)
+{
+    const uint64_t value = __atomic_fetch_add(&header()->next, 1, __ATOMIC_SEQ_CST);
+    if (value > header()->last)
+    {
+        throw ifm::error_type(ifm::LEDGER_EXHAUSTED);
+    }
+
+    // O_APPEND makes the 8 byte record atomic between processes
+    if (::write(m_journal, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))
+        || ::fsync(m_journal) != 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    return Mac48(value);
+}
+
+Mac MacLedger::first() const noexcept { return Mac48(header()->first); }
+
+Mac MacLedger::last() const noexcept { return Mac48(header()->last); }
+
+MacRange MacLedger::range() const noexcept
+{
+    return MacRange::closed(Mac48(header()->first), Mac48(header()->last));
+}
+
+uint64_t MacLedger::remaining() const noexcept
+{
+    const uint64_t next = __atomic_load_n(&header()->next, __ATOMIC_SEQ_CST);
+    return next > header()->last ? 0 : header()->last - next + 1;
+}
+
+std::string MacLedger::journalPath(const std::string& filePath) { return filePath + ".journal"; }
+
+MAC_LEDGER_HEADER* MacLedger::header() noexcept
+{
+    return reinterpret_cast<MAC_LEDGER_HEADER*>(m_file.data());
+}
+
+const MAC_LEDGER_HEADER* MacLedger::header() const noexcept
+{
+    return reinterpret_cast<const MAC_LEDGER_HEADER*>(m_file.data());
+}
@@ -0,0 +1,133 @@
+/** @file lot.cpp
+ *
+ *  @brief contains a compact store for a production lot of images that only differ in the MAC
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/lot.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+static_assert(sizeof(Mac) == 6, "MAC addresses are stored as one block of 6 byte entries");
+
+EepromLot::EepromLot(const EEPROM& base, std::vector<Mac> macs) noexcept
+: m_base(base)
+, m_macs(std::move(macs))
+{
+    m_base.mac = {};
+}
+
+bool EepromLot::isLot(const std::string& filePath) noexcept
+{
+    char magic[sizeof(eeprom_lot_magic)]{};
+    std::ifstream in(filePath, std::ios::binary | std::ios::in);
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, eeprom_lot_magic, sizeof(magic)) == 0;
+}
+
+void EepromLot::add(const EEPROM& image) noexcept(false)
+{
+    EEPROM compare = image;
+    compare.mac = m_base.mac;
+    if (std::memcmp(&compare, &m_base, sizeof(EEPROM)) != 0)
+    {
+        throw ifm::error_type(ifm::LOT_IMAGE_MISMATCH);
+    }
+    m_macs.push_back(image.mac);
+}
+
+EEPROM EepromLot::image(size_t index) const noexcept(false)
+{
+    if (index >= m_macs.size())
+    {
+        throw ifm::error_type(ifm::LOT_IMAGE_NOT_FOUND);
+    }
+    EEPROM eeprom = m_base;
+    eeprom.mac = m_macs[index];
+    return eeprom;
+}
+
+EEPROM EepromLot::image(const Mac& mac) const noexcept(false)
+{
+    const auto it = std::find(m_macs.begin(), m_macs.end(), mac);
+    if (it == m_macs.end())
+    {
+        throw ifm::error_type(ifm::LOT_IMAGE_NOT_FOUND);
+    }
+    return image(static_cast<size_t>(std::distance(m_macs.begin(), it)));
+}
+
+void writeEEPROMLot(const std::string& filePath, const EepromLot& lot) noexcept(false)
+{
+    std::filesystem::path path(filePath);
+    if (path.has_parent_path() && !std::filesystem::exists(path.remove_filename()))
+    {
+        throw ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST);
+    }
+
+    EEPROM_LOT_HEADER header{};
+    std::memcpy(header.magic, eeprom_lot_magic, sizeof(header.magic));
+    header.version = htole32(eeprom_lot_version);
+    header.imageSize = htole32(sizeof(EEPROM));
+    header.count = htole64(lot.size());
+
+    std::ofstream out(filePath, std::ios::binary | std::ios::out);
+    if (!out)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&lot.base()), sizeof(EEPROM));
+    out.write(reinterpret_cast<const char*>(lot.macs().data()), lot.size() * sizeof(Mac));
+    out.close();
+    if (!out)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+}
+
+EepromLot readEEPROMLot(const std::string& filePath) noexcept(false)
+{
+    if (filePath.empty() || !std::filesystem::exists(filePath))
+    {
+        throw ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST);
+    }
+
+    std::ifstream in(filePath, std::ios::binary | std::ios::in);
+    if (!in)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    EEPROM_LOT_HEADER header;
+    EEPROM base;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    in.read(reinterpret_cast<char*>(&base), sizeof(base));
+    const uint64_t count = le64toh(header.count);
+    const uint64_t fileSize = std::filesystem::file_size(filePath);
+    if (!in || std::memcmp(header.magic, eeprom_lot_magic, sizeof(header.magic)) != 0
+        || le32toh(header.version) != eeprom_lot_version
+        || le32toh(header.imageSize) != sizeof(EEPROM)
+        || count != (fileSize - sizeof(header) - sizeof(base)) / sizeof(Mac))
+    {
+        throw ifm::error_type(ifm::LOT_INVALID);
+    }
+
+    std::vector<Mac> macs(count);
+    in.read(reinterpret_cast<char*>(macs.data()), count * sizeof(Mac));
+    if (!in)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+    return EepromLot(base, std::move(macs));
+}
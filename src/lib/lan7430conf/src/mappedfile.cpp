@@ -0,0 +1,91 @@
+/** @file mappedfile.cpp
+ *
+ *  @brief contains a RAII wrapper around a memory mapped file
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/mappedfile.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+MappedFile::MappedFile(const std::string& filePath, Mode mode) noexcept(false)
+{
+    const bool writable = mode == Mode::READ_WRITE;
+    const int fd = ::open(filePath.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw ifm::error_type(errno == ENOENT ? ifm::FILE_PATH_DOESNT_EXIST : ifm::FILE_CANT_READ);
+    }
+
+    struct stat status = {};
+    if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        ::close(fd);
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size > 0)
+    {
+        void* data = ::mmap(nullptr,
+                            m_size,
+                            writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            MAP_SHARED,
+                            fd,
+                            0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            throw ifm::error_type(ifm::FILE_CANT_READ);
+        }
+        m_data = static_cast<Byte*>(data);
+    }
+    ::close(fd);  // the mapping stays valid
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: m_data(std::exchange(other.m_data, nullptr))
+, m_size(std::exchange(other.m_size, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::sync() noexcept(false)
+{
+    if (m_data != nullptr && ::msync(m_data, m_size, MS_SYNC) != 0)
+    {
+        throw ifm::error_type(ifm::FILE_CANT_WRITE);
+    }
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
@@ -0,0 +1,155 @@
+/** @file profile.cpp
+ *
+ *  @brief contains named sets of configuration values that are applied in one step
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/profile.hpp"
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/fields.hpp"
+#include "lan7430conf/stream.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+const std::vector<ConfigProfile>& builtinProfiles() noexcept
+{
+    static const std::vector<ConfigProfile> profiles{
+        // every power saving state the link or the device can enter costs microseconds to leave
+        // the capabilities are overridden, a cleared override bit would leave the hardware
+        // defaults of the LAN7430 in place, EEE has no override bit
+        { "low-latency",
+          "Disables ASPM L1 substates, L1 PM substates, EEE, clock power management, LTR and "
+          "OBFF, which add wake-up latency to the traffic",
+          R"({
+              "aspmL11Support": false, "aspmL12Support": false,
+              "pciPML11Support": false, "pciPML12Support": false,
+              "l1PMSubstatesSupported": false,
+              "energyEfficientEthernet": false, "energyEfficientEthernetTxClockStop": false,
+              "clockPowerManagement": false,
+              "ltrMechanismSupport": false,
+              "obffSupport": 0
+          })",
+          { "aspmL11Support",
+            "aspmL12Support",
+            "pciPML11Support",
+            "pciPML12Support",
+            "l1PMSubstatesSupported",
+            "clockPowerManagement",
+            "ltrMechanismSupport",
+            "obffSupport" } },
+    };
+    return profiles;
+}
+
+ConfigProfile findProfile(const std::string& nameOrPath) noexcept(false)
+{
+    for (const auto& profile : builtinProfiles())
+    {
+        if (profile.name == nameOrPath)
+        {
+            return profile;
+        }
+    }
+    if (!std::filesystem::is_regular_file(nameOrPath))
+    {
+        throw ifm::error_type(ifm::PROFILE_UNKNOWN);
+    }
+    std::ifstream in(nameOrPath, std::ios::binary | std::ios::in);
+    std::stringstream settings;
+    if (!(settings << in.rdbuf()))
+    {
+        throw ifm::error_type(ifm::FILE_CANT_READ);
+    }
+
+    ConfigProfile profile{ std::filesystem::path(nameOrPath).stem().string(),
+                           "Settings of the profile file " + nameOrPath,
+                           settings.str(),
+                           {} };
+    // fail now and not in the middle of a transaction. Every field starts at its maximum, so the
+    // fields that are 0 afterwards are the ones the file turns off
+    EEPROM_CONFIG config{};
+    forEachField([&](const auto& field) {
+        using F = std::decay_t<decltype(field)>;
+        constexpr uint64_t max = (uint64_t{ 1 } << (F::end - F::start + 1)) - 1;
+        field.member(config) = static_cast<typename F::value_type>(max);
+    });
+    applyConfigRecord(profile.settings, config);
+
+    // like the built in profiles a disabled capability is overridden, otherwise the LAN7430 would
+    // keep its hardware default
+    forEachField([&](const auto& field) {
+        using F = std::decay_t<decltype(field)>;
+        using T = typename F::value_type;
+        constexpr bool flagOrEnum = std::is_same_v<T, bool> || std::is_enum_v<T>;
+        if constexpr (flagOrEnum && F::enableBit != no_enable_bit)
+        {
+            if (static_cast<uint64_t>(field.member(config)) == 0)
+            {
+                profile.overrides.emplace_back(field.name);
+            }
+        }
+    });
+    return profile;
+}
+
+std::vector<FieldChange> diffConfig(const EEPROM_CONFIG& before, const EEPROM_CONFIG& after)
+{
+    std::vector<FieldChange> changes;
+    if (before.mac != after.mac)
+    {
+        changes.push_back({ "mac", macToInteger(before.mac), macToInteger(after.mac) });
+    }
+    forEachField([&](const auto& field) {
+        const auto valueBefore = static_cast<uint64_t>(field.member(before));
+        const auto valueAfter = static_cast<uint64_t>(field.member(after));
+        if (valueBefore != valueAfter)
+        {
+            changes.push_back({ field.name, valueBefore, valueAfter });
+        }
+    });
+    return changes;
+}
+
+std::vector<FieldChange> applyProfile(const ConfigProfile& profile,
+                                      EepromRef& eeprom) noexcept(false)
+{
+    const EEPROM_CONFIG before = eepromConfigToEEPROM(eeprom.eeprom());
+    EEPROM_CONFIG after = before;
+    applyConfigRecord(profile.settings, after);
+
+    std::vector<FieldChange> changes;
+    if (before.mac != after.mac)
+    {
+        eeprom.setMac(after.mac);
+        changes.push_back({ "mac", macToInteger(before.mac), macToInteger(after.mac) });
+    }
+    forEachField([&](const auto& field) {
+        const auto valueBefore = static_cast<uint64_t>(field.member(before));
+        const auto valueAfter = static_cast<uint64_t>(field.member(after));
+        const auto& overrides = profile.overrides;
+        const bool forced
+            = std::find(overrides.begin(), overrides.end(), field.name) != overrides.end();
+        const bool overridden = forced && !eeprom.enabled(field);
+        // set() would clear the override bit of a field that changes to 0
+        if (forced)
+        {
+            eeprom.force(field, field.member(after));
+        }
+        else if (valueBefore != valueAfter)
+        {
+            eeprom.set(field, field.member(after));
+        }
+        if (overridden || valueBefore != valueAfter)
+        {
+            changes.push_back({ field.name, valueBefore, valueAfter, overridden });
+        }
+    });
+    return changes;
+}
@@ -0,0 +1,438 @@
+/** @file server.cpp
+ *
+ *  @brief contains a server creating EEPROM images for requests received on a Unix socket
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/server.hpp"
+
+#include "lan7430conf/errors.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t mac_len = std::tuple_size<Mac>::value;
+constexpr size_t template_request_len = sizeof(EepromBytes) + mac_len;
+constexpr size_t read_chunk_len = 64 * 1024;
+
+void appendU32(std::vector<Byte>& buffer, uint32_t value)
+{
+    const auto* bytes = reinterpret_cast<const Byte*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+void appendReply(std::vector<Byte>& buffer, const EepromBytes& image)
+{
+    appendU32(buffer, sizeof(uint32_t) + image.size());
+    appendU32(buffer, ifm::IFM_NO_ERROR);
+    buffer.insert(buffer.end(), image.begin(), image.end());
+}
+
+void appendReply(std::vector<Byte>& buffer, int error)
+{
+    const char* message = ifm::error_type(error).what();
+    const size_t length = std::strlen(message);
+    appendU32(buffer, sizeof(uint32_t) + length);
+    appendU32(buffer, error);
+    buffer.insert(buffer.end(), message, message + length);
+}
+
+bool writeAll(int fd, const std::vector<Byte>& buffer) noexcept
+{
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        // no SIGPIPE if the client went away
+        const ssize_t n
+            = ::send(fd, buffer.data() + written, buffer.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
+
+// the latencies are counted in a log-linear histogram of fixed size: every latency below
+// latency_sub_buckets ns has its own bucket, every power of two above is split into
+// latency_sub_buckets buckets. A percentile is off by less than 1/64, however many requests
+// are served.
+constexpr uint32_t latency_sub_bits = 6;
+constexpr uint64_t latency_sub_buckets = uint64_t{ 1 } << latency_sub_bits;
+constexpr size_t latency_buckets = (64 - latency_sub_bits + 1) * latency_sub_buckets;
+
+size_t latencyBucket(uint64_t nanoseconds)
+{
+    if (nanoseconds < latency_sub_buckets)
+    {
+        return nanoseconds;
+    }
+    uint32_t shift = 0;
+    while ((nanoseconds >> shift) >= 2 * latency_sub_buckets)
+    {
+        ++shift;
+    }
+    return (shift + 1) * latency_sub_buckets + (nanoseconds >> shift) - latency_sub_buckets;
+}
+
+/// the highest latency counted in \p bucket
+uint64_t latencyBucketMax(size_t bucket)
+{
+    if (bucket < latency_sub_buckets)
+    {
+        return bucket;
+    }
+    const uint64_t shift = bucket / latency_sub_buckets - 1;
+    const uint64_t value = latency_sub_buckets + bucket % latency_sub_buckets;
+    // the last bucket wraps around to UINT64_MAX
+    return ((value + 1) << shift) - 1;
+}
+
+/// nearest rank, \p total must not be 0
+std::chrono::nanoseconds percentile(const std::vector<uint64_t>& counts,
+                                    uint64_t total,
+                                    uint64_t max,
+                                    double p)
+{
+    const auto rank = std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(p * total)), 1, total);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+    {
+        seen += counts[bucket];
+        if (seen >= rank)
+        {
+            return std::chrono::nanoseconds(std::min(latencyBucketMax(bucket), max));
+        }
+    }
+    return std::chrono::nanoseconds(max);
+}
+
+}  // namespace
+
+struct EepromServer::Connection
+{
+    int fd{ -1 };
+    std::thread thread;
+    std::atomic<bool> done{ false };
+};
+
+EepromServer::EepromServer(const std::string& socketPath) noexcept(false)
+: m_socketPath(socketPath)
+, m_latencyCounts(latency_buckets)
+{
+    std::filesystem::path path(socketPath);
+    if (path.has_parent_path() && !std::filesystem::exists(path.parent_path()))
+    {
+        throw ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST);
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw ifm::error_type(ifm::SERVER_SOCKET_ERROR);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    // a socket left behind by a previous run is replaced, a served socket or any other file is not
+    struct stat status
+    {
+    };
+    if (::lstat(socketPath.c_str(), &status) == 0)
+    {
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool served
+            = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        ::close(probe);
+        if (!S_ISSOCK(status.st_mode) || served)
+        {
+            throw ifm::error_type(ifm::SERVER_SOCKET_ERROR);
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+    {
+        throw ifm::error_type(ifm::SERVER_SOCKET_ERROR);
+    }
+    if (::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(m_listenFd, SOMAXCONN) != 0
+        || ::pipe2(m_stopPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        ::close(m_listenFd);
+        ::unlink(socketPath.c_str());
+        throw ifm::error_type(ifm::SERVER_SOCKET_ERROR);
+    }
+}
+
+EepromServer::~EepromServer()
+{
+    reap(true);
+    ::close(m_listenFd);
+    ::unlink(m_socketPath.c_str());
+    ::close(m_stopPipe[0]);
+    ::close(m_stopPipe[1]);
+}
+
+void EepromServer::run() noexcept(false)
+{
+    pollfd fds[2]{ { m_listenFd, POLLIN, 0 }, { m_stopPipe[0], POLLIN, 0 } };
+    while (true)
+    {
+        if (::poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw ifm::error_type(ifm::SERVER_SOCKET_ERROR);
+        }
+        if (fds[1].revents != 0)
+        {
+            break;
+        }
+        if (fds[0].revents == 0)
+        {
+            continue;
+        }
+
+        const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;  // the client is gone already (or EINTR), keep serving the others
+        }
+        reap(false);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& connection = *m_connections.emplace_back(std::make_unique<Connection>());
+        connection.fd = fd;
+        try
+        {
+            connection.thread = std::thread(&EepromServer::serve, this, std::ref(connection));
+        }
+        catch (const std::system_error&)
+        {
+            // no thread left (EAGAIN), reap() mustn't join this one, drop the client and go on
+            m_connections.pop_back();
+            ::close(fd);
+            continue;
+        }
+        ++m_connectionCount;
+    }
+
+    // wake up the connections blocked in read, they finish once their replies are written
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& connection : m_connections)
+        {
+            ::shutdown(connection->fd, SHUT_RD);
+        }
+    }
+    reap(true);
+}
+
+void EepromServer::stop() noexcept
+{
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t written = ::write(m_stopPipe[1], &byte, 1);
+}
+
+void EepromServer::reap(bool all)
+{
+    std::list<std::unique_ptr<Connection>> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_connections.begin(); it != m_connections.end();)
+        {
+            auto next = std::next(it);
+            if (all || (*it)->done)
+            {
+                finished.splice(finished.end(), m_connections, it);
+            }
+            it = next;
+        }
+    }
+    // the descriptor is only closed here, so it can't be reused while run() shuts it down
+    for (const auto& connection : finished)
+    {
+        connection->thread.join();
+        ::close(connection->fd);
+    }
+}
+
+void EepromServer::serve(Connection& connection) noexcept
+{
+    std::vector<Byte> in;
+    std::vector<Byte> out;
+    std::vector<Clock::time_point> pending;
+    std::vector<uint64_t> latencyCounts(latency_buckets);
+    uint64_t maxLatency = 0;
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    EepromBytes image{};
+    bool hasTemplate = false;
+
+    try
+    {
+        size_t begin = 0;
+        while (true)
+        {
+            const size_t size = in.size();
+            in.resize(size + read_chunk_len);
+            const ssize_t n = ::read(connection.fd, in.data() + size, read_chunk_len);
+            if (n < 0 && errno == EINTR)
+            {
+                in.resize(size);
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            in.resize(size + n);
+            const auto received = Clock::now();
+
+            // answer all complete requests of this read at once, the client may pipeline them
+            bool close = false;
+            while (in.size() - begin >= sizeof(uint32_t))
+            {
+                uint32_t length = 0;
+                std::memcpy(&length, in.data() + begin, sizeof(length));
+                if (length > server_max_request_len)
+                {
+                    close = true;  // no way to tell garbage from a request
+                    break;
+                }
+                if (in.size() - begin - sizeof(length) < length)
+                {
+                    break;
+                }
+                const Byte* payload = in.data() + begin + sizeof(length);
+                begin += sizeof(length) + length;
+                pending.push_back(received);
+
+                if (length == template_request_len)
+                {
+                    std::memcpy(image.data(), payload, image.size());
+                    payload += image.size();
+                    hasTemplate = true;
+                }
+                else if (length != mac_len)
+                {
+                    appendReply(out, ifm::SERVER_INVALID_REQUEST);
+                    ++errors;
+                    continue;
+                }
+                if (!hasTemplate)
+                {
+                    appendReply(out, ifm::SERVER_NO_TEMPLATE);
+                    ++errors;
+                    continue;
+                }
+
+                std::memcpy(image.data() + offsetof(EEPROM, mac), payload, mac_len);
+                if (const std::error_code error = validateEEPROM(image))
+                {
+                    appendReply(out, error.value());
+                    ++errors;
+                    continue;
+                }
+                appendReply(out, image);
+            }
+            in.erase(in.begin(), in.begin() + begin);
+            begin = 0;
+
+            if (!out.empty())
+            {
+                if (!writeAll(connection.fd, out))
+                {
+                    break;
+                }
+                const auto written = Clock::now();
+                for (const auto& start : pending)
+                {
+                    const auto latency = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(written - start)
+                            .count());
+                    ++latencyCounts[latencyBucket(latency)];
+                    maxLatency = std::max(maxLatency, latency);
+                }
+                requests += pending.size();
+                pending.clear();
+                out.clear();
+            }
+            if (close)
+            {
+                break;
+            }
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        // drop the connection, the server keeps running
+    }
+    // the client sees the end of the connection now, the descriptor is closed once reaped
+    ::shutdown(connection.fd, SHUT_RDWR);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests += requests;
+        m_errors += errors;
+        for (size_t bucket = 0; bucket < latency_buckets; ++bucket)
+        {
+            m_latencyCounts[bucket] += latencyCounts[bucket];
+        }
+        m_maxLatency = std::max(m_maxLatency, maxLatency);
+    }
+    connection.done = true;
+}
+
+ServerStatistics EepromServer::statistics() const
+{
+    ServerStatistics statistics;
+    std::vector<uint64_t> counts;
+    uint64_t max = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        statistics.connections = m_connectionCount;
+        statistics.requests = m_requests;
+        statistics.errors = m_errors;
+        counts = m_latencyCounts;
+        max = m_maxLatency;
+    }
+    if (statistics.requests == 0)
+    {
+        return statistics;
+    }
+    statistics.p50 = percentile(counts, statistics.requests, max, 0.5);
+    statistics.p90 = percentile(counts, statistics.requests, max, 0.9);
+    statistics.p99 = percentile(counts, statistics.requests, max, 0.99);
+    statistics.p999 = percentile(counts, statistics.requests, max, 0.999);
+    statistics.max = std::chrono::nanoseconds(max);
+    return statistics;
+}
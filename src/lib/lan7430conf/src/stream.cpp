@@ -0,0 +1,643 @@
+/** @file stream.cpp
+ *
+ *  @brief contains functions to create EEPROM images for a stream of newline delimited JSON
+ *  records
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/stream.hpp"
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/fields.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr size_t batch_len = 256;
+constexpr size_t read_chunk_len = 64 * 1024;
+constexpr int max_nesting = 8;
+
+/**
+ * @brief queue of at most capacity items, push blocks while it is full
+ * after close() push fails and pop returns the remaining items, then nothing
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+    : m_capacity(capacity == 0 ? 1 : capacity)
+    {
+    }
+
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        wait(lock, m_notFull, [this]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+        {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        wait(lock, m_notEmpty, [this]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+        {
+            return std::nullopt;
+        }
+        T item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return item;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+private:
+    /// blocks until \p predicate holds. Since GCC 12 condition_variable::wait(lock) is exported as
+    /// GLIBCXX_3.4.30, the wait without a deadline keeps older libstdc++ runtimes working.
+    template<typename Predicate>
+    static void wait(std::unique_lock<std::mutex>& lock,
+                     std::condition_variable& condition,
+                     Predicate predicate)
+    {
+        condition.wait_until(lock, std::chrono::steady_clock::time_point::max(), predicate);
+    }
+
+    const size_t m_capacity;
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<T> m_items;
+    bool m_closed{ false };
+};
+
+struct JsonValue
+{
+    enum class KIND
+    {
+        NUMBER,
+        BOOLEAN,
+        STRING,
+        NUL,
+    };
+    KIND kind{ KIND::NUL };
+    uint64_t number{ 0 };  // also the value of booleans
+    std::string string;
+};
+
+template<typename F>
+bool setField(const F& field, EEPROM_CONFIG& config, const JsonValue& value)
+{
+    using T = typename F::value_type;
+    constexpr uint64_t max = (uint64_t{ 1 } << (F::end - F::start + 1)) - 1;
+
+    const bool isNumber = value.kind == JsonValue::KIND::NUMBER;
+    const bool isBoolean = value.kind == JsonValue::KIND::BOOLEAN && std::is_same_v<T, bool>;
+    if ((!isNumber && !isBoolean) || value.number > max)
+    {
+        return false;
+    }
+    field.member(config) = static_cast<T>(value.number);
+    return true;
+}
+
+using Setter = std::function<bool(EEPROM_CONFIG&, const JsonValue&)>;
+
+const std::unordered_map<std::string, Setter>& setters()
+{
+    static const auto map = []() {
+        std::unordered_map<std::string, Setter> map;
+        forEachField([&](const auto& field) {
+            map.emplace(field.name, [field](EEPROM_CONFIG& config, const JsonValue& value) {
+                return setField(field, config, value);
+            });
+        });
+        return map;
+    }();
+    return map;
+}
+
+/**
+ * @brief recursive descent parser for a single record, values are applied while parsing
+ */
+class RecordParser
+{
+public:
+    RecordParser(std::string_view text, EEPROM_CONFIG& config)
+    : m_text(text)
+    , m_config(config)
+    {
+    }
+
+    void parse()
+    {
+        skipSpace();
+        if (peek() != '{')
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+        std::string path;
+        parseValue(path, 0);
+        skipSpace();
+        if (m_pos != m_text.size())
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+    }
+
+private:
+    char peek() const { return m_pos < m_text.size() ? m_text[m_pos] : '\0'; }
+
+    void skipSpace()
+    {
+        while (peek() == ' ' || peek() == '\t' || peek() == '\r' || peek() == '\n')
+        {
+            ++m_pos;
+        }
+    }
+
+    void expect(char c)
+    {
+        skipSpace();
+        if (peek() != c)
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+        ++m_pos;
+    }
+
+    void expectLiteral(std::string_view literal)
+    {
+        if (m_text.substr(m_pos, literal.size()) != literal)
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+        m_pos += literal.size();
+    }
+
+    std::string parseString()
+    {
+        expect('"');
+        std::string string;
+        while (true)
+        {
+            const char c = peek();
+            ++m_pos;
+            if (c == '"')
+            {
+                return string;
+            }
+            if (c == '\0' || static_cast<unsigned char>(c) < 0x20)
+            {
+                throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+            }
+            if (c != '\\')
+            {
+                string += c;
+                continue;
+            }
+            // names and MAC addresses are plain ASCII, \u escapes are not needed
+            const char escaped = peek();
+            ++m_pos;
+            switch (escaped)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                string += escaped;
+                break;
+            case 'b':
+                string += '\b';
+                break;
+            case 'f':
+                string += '\f';
+                break;
+            case 'n':
+                string += '\n';
+                break;
+            case 'r':
+                string += '\r';
+                break;
+            case 't':
+                string += '\t';
+                break;
+            default:
+                throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+            }
+        }
+    }
+
+    void parseValue(std::string& path, int depth)
+    {
+        if (depth > max_nesting)
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+        skipSpace();
+        const char c = peek();
+        if (c == '{' || c == '[')
+        {
+            const bool object = c == '{';
+            const char close = object ? '}' : ']';
+            ++m_pos;
+            skipSpace();
+            if (peek() == close)
+            {
+                ++m_pos;
+                return;
+            }
+            const size_t length = path.size();
+            for (size_t index = 0;; ++index)
+            {
+                if (object)
+                {
+                    const std::string name = parseString();
+                    expect(':');
+                    path += (length == 0 ? "" : ".") + name;
+                }
+                else
+                {
+                    path += "[" + std::to_string(index) + "]";
+                }
+                parseValue(path, depth + 1);
+                path.resize(length);
+
+                skipSpace();
+                if (peek() != ',')
+                {
+                    break;
+                }
+                ++m_pos;
+            }
+            expect(close);
+            return;
+        }
+
+        JsonValue value;
+        if (c == '"')
+        {
+            value.kind = JsonValue::KIND::STRING;
+            value.string = parseString();
+        }
+        else if (c == 't' || c == 'f')
+        {
+            value.kind = JsonValue::KIND::BOOLEAN;
+            value.number = c == 't';
+            expectLiteral(c == 't' ? "true" : "false");
+        }
+        else if (c == 'n')
+        {
+            expectLiteral("null");
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            value.kind = JsonValue::KIND::NUMBER;
+            while (peek() >= '0' && peek() <= '9')
+            {
+                const uint64_t digit = peek() - '0';
+                if (value.number > (UINT64_MAX - digit) / 10)
+                {
+                    throw ifm::error_type(ifm::STREAM_INVALID_VALUE);
+                }
+                value.number = value.number * 10 + digit;
+                ++m_pos;
+            }
+            // fractions and exponents are valid JSON, but never valid values
+            if (peek() == '.' || peek() == 'e' || peek() == 'E')
+            {
+                throw ifm::error_type(ifm::STREAM_INVALID_VALUE);
+            }
+        }
+        else if (c == '-')
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_VALUE);
+        }
+        else
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_RECORD);
+        }
+        apply(path, value);
+    }
+
+    void apply(const std::string& path, const JsonValue& value)
+    {
+        if (path == "mac")
+        {
+            if (value.kind != JsonValue::KIND::STRING)
+            {
+                throw ifm::error_type(ifm::STREAM_INVALID_VALUE);
+            }
+            m_config.mac = stringToMac(value.string);
+            return;
+        }
+        const auto setter = setters().find(path);
+        if (setter == setters().end())
+        {
+            throw ifm::error_type(ifm::STREAM_UNKNOWN_MEMBER);
+        }
+        if (!setter->second(m_config, value))
+        {
+            throw ifm::error_type(ifm::STREAM_INVALID_VALUE);
+        }
+    }
+
+    std::string_view m_text;
+    size_t m_pos{ 0 };
+    EEPROM_CONFIG& m_config;
+};
+
+struct Record
+{
+    uint64_t line{ 0 };
+    std::string text;
+    bool tooLong{ false };
+};
+using Batch = std::vector<Record>;
+
+void appendU32(std::string& out, uint32_t value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendBase64(std::string& out, const EepromBytes& bytes)
+{
+    static constexpr char table[]
+        = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (; i + 3 <= bytes.size(); i += 3)
+    {
+        const uint32_t triple = bytes[i] << 16 | bytes[i + 1] << 8 | bytes[i + 2];
+        out += table[triple >> 18 & 0x3f];
+        out += table[triple >> 12 & 0x3f];
+        out += table[triple >> 6 & 0x3f];
+        out += table[triple & 0x3f];
+    }
+    if (i < bytes.size())
+    {
+        const bool two = i + 1 < bytes.size();
+        const uint32_t triple = bytes[i] << 16 | (two ? bytes[i + 1] << 8 : 0);
+        out += table[triple >> 18 & 0x3f];
+        out += table[triple >> 12 & 0x3f];
+        out += two ? table[triple >> 6 & 0x3f] : '=';
+        out += '=';
+    }
+}
+
+void appendReply(std::string& out, STREAM_FORMAT format, uint64_t line, const EepromBytes& image)
+{
+    if (format == STREAM_FORMAT::BINARY)
+    {
+        appendU32(out, sizeof(uint32_t) + image.size());
+        appendU32(out, ifm::IFM_NO_ERROR);
+        out.append(reinterpret_cast<const char*>(image.data()), image.size());
+        return;
+    }
+    Mac mac{};
+    std::memcpy(mac.data(), image.data() + offsetof(EEPROM, mac), mac.size());
+    char macChars[mac_string_len];
+    macToChars(mac, macChars);
+    out += "{\"record\":";
+    out += std::to_string(line);
+    out += ",\"mac\":\"";
+    out.append(macChars, sizeof(macChars));
+    out += "\",\"image\":\"";
+    appendBase64(out, image);
+    out += "\"}\n";
+}
+
+void appendReply(std::string& out, STREAM_FORMAT format, uint64_t line, int error)
+{
+    const char* message = ifm::error_type(error).what();
+    if (format == STREAM_FORMAT::BINARY)
+    {
+        appendU32(out, sizeof(uint32_t) + std::strlen(message));
+        appendU32(out, error);
+        out += message;
+        return;
+    }
+    // the messages don't contain characters that need escaping
+    out += "{\"record\":" + std::to_string(line) + ",\"error\":" + std::to_string(error)
+           + ",\"message\":\"" + message + "\"}\n";
+}
+
+/// splits \p in into records, returns once \p in is exhausted or \p batches is closed
+void readRecords(std::istream& in, BoundedQueue<Batch>& batches)
+{
+    std::vector<char> buffer(read_chunk_len);
+    Batch batch;
+    Record record;
+
+    const auto finishRecord = [&]() {
+        ++record.line;
+        if (!record.text.empty() && record.text.back() == '\r')
+        {
+            record.text.pop_back();
+        }
+        if (record.tooLong
+            || record.text.find_first_not_of(" \t") != std::string::npos)
+        {
+            batch.push_back(std::move(record));
+        }
+        record.text.clear();
+        record.tooLong = false;
+        if (batch.size() < batch_len)
+        {
+            return true;
+        }
+        const bool pushed = batches.push(std::move(batch));
+        batch.clear();
+        return pushed;
+    };
+
+    // only the wait for the first byte blocks, after that just the bytes that are available are
+    // taken, so the records of a live feed are answered as they arrive and not once a whole chunk
+    // or batch has been read
+    std::streambuf* streambuf = in.rdbuf();
+    while (streambuf != nullptr && streambuf->sgetc() != std::streambuf::traits_type::eof())
+    {
+        const std::streamsize available = std::clamp<std::streamsize>(
+            streambuf->in_avail(), 1, static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize n = streambuf->sgetn(buffer.data(), available);
+        const char* begin = buffer.data();
+        const char* end = begin + n;
+        while (begin < end)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            const char* segmentEnd = newline != nullptr ? newline : end;
+            const size_t length = segmentEnd - begin;
+            if (record.tooLong || record.text.size() + length > stream_max_record_len)
+            {
+                record.tooLong = true;
+                record.text.clear();
+            }
+            else
+            {
+                record.text.append(begin, length);
+            }
+            begin = segmentEnd;
+            if (newline != nullptr)
+            {
+                ++begin;
+                if (!finishRecord())
+                {
+                    return;
+                }
+            }
+        }
+        // no more input right now, don't keep the records back until the batch is full
+        if (!batch.empty() && streambuf->in_avail() <= 0)
+        {
+            if (!batches.push(std::move(batch)))
+            {
+                return;
+            }
+            batch.clear();
+        }
+    }
+    if (!record.text.empty() || record.tooLong)
+    {
+        finishRecord();
+    }
+    if (!batch.empty())
+    {
+        batches.push(std::move(batch));
+    }
+}
+
+}  // namespace
+
+void applyConfigRecord(const std::string& record, EEPROM_CONFIG& config) noexcept(false)
+{
+    RecordParser(record, config).parse();
+}
+
+StreamStatistics streamEEPROMs(std::istream& in,
+                               std::ostream& out,
+                               const EEPROM_CONFIG& defaults,
+                               STREAM_FORMAT format,
+                               size_t queueDepth) noexcept(false)
+{
+    BoundedQueue<Batch> batches(queueDepth);
+    BoundedQueue<std::string> replies(queueDepth);
+    StreamStatistics statistics;
+
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    const auto fail = [&](std::exception_ptr exception) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+            {
+                error = exception;
+            }
+        }
+        batches.close();
+        replies.close();
+    };
+
+    std::thread reader([&]() {
+        try
+        {
+            readRecords(in, batches);
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+        batches.close();
+    });
+
+    std::thread encoder([&]() {
+        try
+        {
+            EepromBytes image{};
+            while (auto batch = batches.pop())
+            {
+                std::string chunk;
+                for (const auto& record : *batch)
+                {
+                    ++statistics.records;
+                    int code = ifm::STREAM_INVALID_RECORD;
+                    if (!record.tooLong)
+                    {
+                        try
+                        {
+                            EEPROM_CONFIG config = defaults;
+                            applyConfigRecord(record.text, config);
+                            code = encodeEEPROM(config, image).value();
+                        }
+                        catch (const ifm::error_type& e)
+                        {
+                            code = e.code();
+                        }
+                    }
+                    if (code == ifm::IFM_NO_ERROR)
+                    {
+                        appendReply(chunk, format, record.line, image);
+                    }
+                    else
+                    {
+                        appendReply(chunk, format, record.line, code);
+                        ++statistics.errors;
+                    }
+                }
+                if (!replies.push(std::move(chunk)))
+                {
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+        replies.close();
+    });
+
+    while (auto chunk = replies.pop())
+    {
+        // flushed per chunk, the replies of a live feed must not wait for the end of the stream
+        if (!out.write(chunk->data(), chunk->size()).flush())
+        {
+            fail(std::make_exception_ptr(ifm::error_type(ifm::FILE_CANT_WRITE)));
+            break;
+        }
+    }
+
+    reader.join();
+    encoder.join();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return statistics;
+}
@@ -12,10 +12,91 @@
 #include "lan7430conf/lan7430conf.hpp"
 #include "lan7430conf/errors.hpp"
 
+#include <spdlog/fmt/fmt.h>
+
+#include <random>
+#include <regex>
+
+namespace {
+/// the regex based parser stringToMac was built on, reference for syntax and benchmark
+bool regexStringToMac(const std::string& macString, Mac& mac)
+{
+    std::regex rx(
+        R"(^(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])(?:([0-9A-Fa-f]{2})[:-])([0-9A-Fa-f]{2})$)",
+        std::regex::icase);
+    std::smatch match;
+    if (!std::regex_match(macString, match, rx))
+    {
+        return false;
+    }
+    for (size_t i = 1; i < match.size(); i++)
+    {
+        mac[i - 1] = static_cast<Byte>(std::stoul(match[i].str(), nullptr, 16));
+    }
+    return true;
+}
+
+std::vector<std::string> macStrings(size_t count)
+{
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < count; ++i)
+    {
+        strings.push_back(macToString(incrementMac(Mac{ 0x00, 0x02, 0x01, 0x23, 0x10, 0x00 }, i)));
+    }
+    return strings;
+}
+}  // namespace
+
 TEST_CASE("valid MAC", "[MAC]")
 {
     Mac mac;
     REQUIRE_NOTHROW(mac = stringToMac("02:42:00:cf:36:c1"));
+    REQUIRE(mac == Mac{ 0x02, 0x42, 0x00, 0xcf, 0x36, 0xc1 });
+    REQUIRE(stringToMac("02-42:00-CF:36-c1") == mac);
+}
+
+TEST_CASE("parse MAC like regex", "[MAC]")
+{
+    // single character substitutions of valid strings hit every position with every byte
+    std::mt19937 random(7430);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<size_t> position(0, 16);
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string macString = i % 2 == 0 ? "0a:1B-2c:3D-4e:5F" : "9f-80-A7:b6:C5:d4";
+        macString[position(random)] = static_cast<char>(byte(random));
+        if (i % 7 == 0)
+        {
+            macString.resize(position(random));
+        }
+        else if (i % 11 == 0)
+        {
+            macString += static_cast<char>(byte(random));
+        }
+        INFO(macString);
+        Mac expected{};
+        Mac mac{};
+        const std::error_code error = parseMac(macString, mac);
+        REQUIRE(regexStringToMac(macString, expected) == !error);
+        REQUIRE(mac == (error ? Mac{} : expected));
+    }
+}
+
+TEST_CASE("parse MACs", "[MAC]")
+{
+    std::vector<std::string_view> strings{ "00-02-01-23-10-55", "", "00-02-01-23-10",
+                                           "00:02:01:23:10:56" };
+    std::vector<Mac> macs;
+    std::vector<std::error_code> errors;
+    REQUIRE(parseMacs(strings, macs, errors) == 2);
+    REQUIRE(macs
+            == std::vector<Mac>{ stringToMac("00-02-01-23-10-55"), Mac{}, Mac{},
+                                 stringToMac("00-02-01-23-10-56") });
+    REQUIRE(errors
+            == std::vector<std::error_code>{ {},
+                                             ifm::make_error_code(ifm::MAC_ADDRESS_EMPTY),
+                                             ifm::make_error_code(ifm::MAC_ADDRESS_INVALID),
+                                             {} });
 }
 
 TEST_CASE("invalid MAC", "[MAC]")
@@ -48,3 +129,112 @@ TEST_CASE("MAC to string", "[MAC]")
     std::string macString2 = macToString(mac2);
     REQUIRE_THAT(macString2, Catch::Equals("AA-BB-CC-DD-EE-FF"));
 }
+
+TEST_CASE("MAC to chars", "[MAC]")
+{
+    // every byte value at every position
+    for (unsigned int value = 0; value < 256; ++value)
+    {
+        const Byte byte = static_cast<Byte>(value);
+        const Mac mac{ byte, static_cast<Byte>(~byte), byte, 0x00, byte, 0xFF };
+        char chars[mac_string_len];
+        macToChars(mac, chars);
+        REQUIRE(std::string(chars, sizeof(chars)) == fmt::format("{:02X}", fmt::join(mac, "-")));
+        REQUIRE(macToString(mac) == std::string(chars, sizeof(chars)));
+    }
+}
+
+TEST_CASE("MACs to chars", "[MAC]")
+{
+    const std::vector<Mac> macs{ stringToMac("00-02-01-23-10-55"),
+                                 stringToMac("AA-BB-CC-DD-EE-FF") };
+    std::string manifest = "_________________\n_________________\n";
+    macsToChars(macs.data(), macs.size(), manifest.data(), mac_string_len + 1);
+    REQUIRE(manifest == "00-02-01-23-10-55\nAA-BB-CC-DD-EE-FF\n");
+
+    std::string packed(2 * mac_string_len, '_');
+    macsToChars(macs.data(), macs.size(), packed.data());
+    REQUIRE(packed == "00-02-01-23-10-55AA-BB-CC-DD-EE-FF");
+}
+
+TEST_CASE("increment MAC", "[MAC]")
+{
+    REQUIRE(incrementMac(stringToMac("00-02-01-23-10-54")) == stringToMac("00-02-01-23-10-55"));
+    REQUIRE(incrementMac(stringToMac("00-02-01-23-10-FF")) == stringToMac("00-02-01-23-11-00"));
+    REQUIRE(incrementMac(stringToMac("00-FF-FF-FF-FF-FF")) == stringToMac("01-00-00-00-00-00"));
+    REQUIRE(incrementMac(stringToMac("00-02-01-23-10-54"), 0x100)
+            == stringToMac("00-02-01-23-11-54"));
+    REQUIRE(incrementMac(stringToMac("00-02-01-23-10-54"), 0) == stringToMac("00-02-01-23-10-54"));
+}
+
+TEST_CASE("increment MAC overflow", "[MAC]")
+{
+    Mac mac;
+    REQUIRE_THROWS_WITH(mac = incrementMac(stringToMac("FF-FF-FF-FF-FF-FF")),
+                        ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    REQUIRE_THROWS_WITH(mac = incrementMac(stringToMac("FF-FF-FF-FF-FF-00"), 0x100),
+                        ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    REQUIRE_NOTHROW(mac = incrementMac(stringToMac("FF-FF-FF-FF-FF-00"), 0xFF));
+}
+
+TEST_CASE("benchmark MAC parser", "[.][benchmark]")
+{
+    const std::vector<std::string> strings = macStrings(1000);
+    const std::vector<std::string_view> views(strings.begin(), strings.end());
+    std::vector<Mac> macs;
+    std::vector<std::error_code> errors;
+
+    BENCHMARK("regex")
+    {
+        Mac mac{};
+        for (const auto& macString : strings)
+        {
+            regexStringToMac(macString, mac);
+        }
+        return mac;
+    };
+    BENCHMARK("stringToMac")
+    {
+        Mac mac{};
+        for (const auto& macString : strings)
+        {
+            mac = stringToMac(macString);
+        }
+        return mac;
+    };
+    BENCHMARK("parseMacs") { return parseMacs(views, macs, errors); };
+}
+
+TEST_CASE("benchmark MAC formatter", "[.][benchmark]")
+{
+    std::vector<Mac> macs;
+    for (const auto& macString : macStrings(1000))
+    {
+        macs.push_back(stringToMac(macString));
+    }
+    std::vector<char> buffer(macs.size() * mac_string_len);
+
+    BENCHMARK("fmt::join")
+    {
+        std::string macString;
+        for (const auto& mac : macs)
+        {
+            macString = fmt::format("{:02X}", fmt::join(mac, "-"));
+        }
+        return macString;
+    };
+    BENCHMARK("macToString")
+    {
+        std::string macString;
+        for (const auto& mac : macs)
+        {
+            macString = macToString(mac);
+        }
+        return macString;
+    };
+    BENCHMARK("macsToChars")
+    {
+        macsToChars(macs.data(), macs.size(), buffer.data());
+        return buffer[0];
+    };
+}
@@ -0,0 +1,99 @@
+/** @file 011-testMac48.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/mac48.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+namespace {
+constexpr Mac48 ifm_mac(Mac{ 0x00, 0x02, 0x01, 0x23, 0x10, 0xFF });
+static_assert(ifm_mac.value() == 0x0002012310FF);
+static_assert(ifm_mac.oui() == 0x000201 && ifm_mac.nic() == 0x2310FF);
+static_assert(Mac48(Mac(ifm_mac + 1)) == Mac48(0x000201231100));
+static_assert(distance(ifm_mac, ifm_mac + 0x101) == 0x101);
+static_assert(distance(ifm_mac + 0x101, ifm_mac) == -0x101);
+static_assert(Mac48(uint64_t(-1)).value() == Mac48::max_value);
+
+constexpr MacRange ifm_range(ifm_mac, 0x100);
+static_assert(ifm_range.contains(ifm_mac) && ifm_range.contains(ifm_mac + 0xff));
+static_assert(!ifm_range.contains(ifm_mac - 1) && !ifm_range.contains(ifm_mac + 0x100));
+static_assert(MacRange(Mac48(), Mac48::max_value + 1).size() == Mac48::max_value + 1);
+}  // namespace
+
+TEST_CASE("Mac48 conversion", "[Mac48]")
+{
+    const Mac mac = stringToMac("00-02-01-23-10-55");
+    const Mac48 mac48 = mac;
+    REQUIRE(mac48.value() == macToInteger(mac));
+    REQUIRE(Mac(mac48) == mac);
+    REQUIRE(mac48 == mac);
+    REQUIRE(mac48.toString() == "00-02-01-23-10-55");
+
+    // codec APIs take a Mac48 like a Mac
+    EEPROM_CONFIG config;
+    config.mac = mac48 + 1;
+    REQUIRE(createEEPROM(config).mac == stringToMac("00-02-01-23-10-56"));
+    REQUIRE(incrementMac(mac48) == mac48 + 1);
+}
+
+TEST_CASE("Mac48 overflow", "[Mac48]")
+{
+    const Mac48 max(Mac48::max_value);
+    REQUIRE_NOTHROW(Mac48() + Mac48::max_value);
+    REQUIRE_THROWS_WITH(max + 1, ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    REQUIRE_THROWS_WITH(Mac48() - 1, ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    Mac48 mac(Mac48::max_value - 1);
+    REQUIRE(++mac == max);
+    REQUIRE_THROWS_WITH(++mac, ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    REQUIRE(mac == max);
+}
+
+TEST_CASE("MacRange", "[Mac48]")
+{
+    const Mac48 first = stringToMac("00-02-01-23-10-00");
+    const MacRange range(first, 0x200);
+    REQUIRE(range.first() == first);
+    REQUIRE(range.last() == stringToMac("00-02-01-23-11-FF"));
+    REQUIRE(range[0x1ff] == range.last());
+    REQUIRE_THROWS_WITH(range[0x200], ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+    REQUIRE(MacRange::closed(range.first(), range.last()) == range);
+    REQUIRE(MacRange::closed(range.last(), range.first()).empty());
+    REQUIRE_THROWS_WITH(MacRange(Mac48(Mac48::max_value), 2),
+                        ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+
+    // intersection and containment
+    const MacRange head(first - 0x10, 0x20);
+    const MacRange tail(range.last(), 0x10);
+    REQUIRE(range.intersection(head) == MacRange(first, 0x10));
+    REQUIRE(head.intersection(range) == MacRange(first, 0x10));
+    REQUIRE(range.intersection(tail) == MacRange(range.last(), 1));
+    REQUIRE(head.intersection(tail).empty());
+    REQUIRE(!head.overlaps(tail));
+    REQUIRE(range.overlaps(head));
+    REQUIRE(range.contains(MacRange(first + 1, 0x1ff)));
+    REQUIRE(!range.contains(MacRange(first + 1, 0x200)));
+    REQUIRE(range.contains(MacRange()));
+    REQUIRE(MacRange(first, 0) == MacRange(range.last(), 0));
+
+    // iteration carries into the upper bytes
+    std::vector<Mac> macs(range.begin(), range.end());
+    REQUIRE(macs.size() == range.size());
+    for (size_t i = 0; i < macs.size(); ++i)
+    {
+        REQUIRE(macs[i] == incrementMac(first, i));
+    }
+
+    // one line per address
+    const MacRange lines(stringToMac("00-02-01-23-10-FF"), 2);
+    std::string manifest(lines.size() * (mac_string_len + 1), '\n');
+    lines.toChars(manifest.data(), mac_string_len + 1);
+    REQUIRE(manifest == "00-02-01-23-10-FF\n00-02-01-23-11-00\n");
+}
@@ -130,6 +130,34 @@ TEST_CASE("compareAgainstFiles", "[WriteEEPROM]")
     }
 }
 
+TEST_CASE("patchMacOfRawEEPROM", "[WriteEEPROM]")
+{
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    EEPROM eeprom = createEEPROM(config);
+
+    const std::vector<std::pair<std::string, std::string>> macStrings{
+        { "00-02-01-23-10-55", "files/00-02-01-23-10-55-pad.bin" },
+        { "00-02-01-23-10-58", "files/00-02-01-23-10-58-pad.bin" }
+    };
+    for (const auto& [macString, eepromFilePath] : macStrings)
+    {
+        std::string tempFilePath
+            = std::filesystem::temp_directory_path().append(macString + "-raw.bin").string();
+
+        eeprom.mac = stringToMac(macString);
+        REQUIRE_NOTHROW(writeRawEEPROM(tempFilePath, eeprom));
+
+        std::ifstream file_orig(eepromFilePath, std::ifstream::binary);
+        std::ifstream file_new(tempFilePath, std::ifstream::binary);
+        REQUIRE(!file_orig.fail());
+        REQUIRE(!file_new.fail());
+        REQUIRE(std::equal(std::istreambuf_iterator<char>(file_orig.rdbuf()),
+                           std::istreambuf_iterator<char>(),
+                           std::istreambuf_iterator<char>(file_new.rdbuf())));
+    }
+}
+
 TEST_CASE("testWriteDefaultFiles", "[WriteEEPROM]")
 {
     for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
@@ -177,3 +205,34 @@ TEST_CASE("testWriteDefaultFiles", "[WriteEEPROM]")
             file_content_orig.begin(), file_content_orig.end(), file_content_new.begin()));
     }
 }
+
+TEST_CASE("replaceRawEEPROM", "[WriteEEPROM]")
+{
+    const std::filesystem::path tempFilePath
+        = std::filesystem::temp_directory_path().append("lan7430-replace.bin");
+    const std::filesystem::path folder = tempFilePath.parent_path();
+
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    config.mac = stringToMac("00-02-01-23-10-55");
+    EEPROM eeprom = createEEPROM(config);
+    REQUIRE_NOTHROW(writeRawEEPROM(tempFilePath.string(), eeprom));
+
+    // the existing file is replaced as a whole
+    eeprom.mac = stringToMac("00-02-01-23-10-58");
+    REQUIRE_NOTHROW(replaceEEPROM(tempFilePath.string(), eeprom));
+    REQUIRE(std::filesystem::file_size(tempFilePath) == sizeof(EEPROM));
+    REQUIRE(readEEPROM(tempFilePath.string()).mac == eeprom.mac);
+
+    // no temporary files are left behind
+    size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(folder))
+    {
+        const std::string name = entry.path().filename().string();
+        files += name.rfind(tempFilePath.filename().string(), 0) == 0 ? 1 : 0;
+    }
+    REQUIRE(files == 1);
+
+    REQUIRE_THROWS_WITH(replaceEEPROM("/tmp/this/is/some/random/path/to/nowhere.bin", eeprom),
+                        ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST).what());
+}
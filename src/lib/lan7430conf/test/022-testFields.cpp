@@ -0,0 +1,248 @@
+/** @file 022-testFields.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/fields.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "shared.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+/// sets every bit of the field, enums and bools are set to their largest raw value
+template<typename F>
+void setAllBits(const F& field, EEPROM_CONFIG& config)
+{
+    field.member(config) = static_cast<typename F::value_type>(F::mask >> F::start);
+}
+}  // namespace
+
+TEST_CASE("decodeTestFiles", "[Fields]")
+{
+    for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
+    {
+        const EEPROM_CONFIG decoded = eepromConfigToEEPROM(readEEPROM(eepromFilePath));
+        REQUIRE(decoded.mac == eepromConfig.mac);
+        forEachField([&, &expected = eepromConfig](const auto& field) {
+            INFO(eepromFilePath << ": " << field.name);
+            REQUIRE(field.member(decoded) == field.member(expected));
+        });
+    }
+}
+
+TEST_CASE("encodeDecodeRoundTrip", "[Fields]")
+{
+    for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
+    {
+        const EEPROM eeprom = createEEPROM(eepromConfig);
+        const EEPROM_CONFIG decoded = eepromConfigToEEPROM(eeprom);
+        forEachField([&, &expected = eepromConfig](const auto& field) {
+            INFO(eepromFilePath << ": " << field.name);
+            REQUIRE(field.member(decoded) == field.member(expected));
+        });
+
+        const EEPROM encoded = createEEPROM(decoded);
+        REQUIRE(std::memcmp(&encoded, &eeprom, sizeof(EEPROM)) == 0);
+    }
+}
+
+TEST_CASE("fieldsDoNotOverlap", "[Fields]")
+{
+    std::array<Byte, sizeof(EEPROM)> used{};
+    std::set<uint32_t> enableBits;
+    std::set<std::string> names;
+    forEachField([&](const auto& field) {
+        INFO(field.name);
+        REQUIRE(names.insert(field.name).second);
+        if (field.enableBit != no_enable_bit)
+        {
+            REQUIRE(enableBits.insert(field.enableBit).second);
+        }
+
+        EEPROM_CONFIG config{};
+        setAllBits(field, config);
+        EEPROM eeprom{};
+        encodeField(field, config, eeprom);
+        // the enable word is checked above, clear it to compare the values only
+        for (auto enableByte : eeprom_enable_word)
+        {
+            eeprom.*enableByte = 0;
+        }
+
+        const auto* bytes = reinterpret_cast<const Byte*>(&eeprom);
+        for (size_t i = 0; i < used.size(); ++i)
+        {
+            REQUIRE((used[i] & bytes[i]) == 0);
+            used[i] |= bytes[i];
+        }
+    });
+}
+
+TEST_CASE("encodeFieldClearsOnlyItsBits", "[Fields]")
+{
+    EEPROM eeprom{};
+    std::memset(&eeprom, 0xff, sizeof(EEPROM));
+
+    EEPROM_CONFIG config{};
+    config.obffSupport = OBFF_SUPPORT::NOT_SUPPORTED;
+    encodeField(fields::obffSupport, config, eeprom);
+    REQUIRE(eeprom.deviceCapabilities_2 == 0xf3);
+    REQUIRE(eeprom.l1PMSubstatesCapabilitesEnable == 0xfe);
+
+    config.obffSupport = OBFF_SUPPORT::WAKE_SIGNALING;
+    encodeField(fields::obffSupport, config, eeprom);
+    REQUIRE(eeprom.deviceCapabilities_2 == 0xfb);
+    REQUIRE(eeprom.l1PMSubstatesCapabilitesEnable == 0xff);
+
+    config.ledConfig[2].control = LED_CONTROL::LINK_10_100_ACTIVITY;
+    encodeField(fields::led2Control, config, eeprom);
+    REQUIRE(eeprom.ledConfig2 == htobe16(0xf6ff));
+}
+
+TEST_CASE("decodeFromValueRegisters", "[Fields]")
+{
+    // OBFF and the EEE TX clock stop used to be decoded from other registers than encoded to
+    EEPROM eeprom{};
+    eeprom.deviceCapabilities_2 = 0x0c;
+    eeprom.powerManagementCapabilities = 0x00;
+    eeprom.macConfig1 = 0x00;
+    eeprom.macConfig2 = 0x01;
+
+    const EEPROM_CONFIG config = eepromConfigToEEPROM(eeprom);
+    REQUIRE(config.obffSupport == OBFF_SUPPORT::WAKE_MESSAGE_SIGNALING);
+    REQUIRE(config.energyEfficientEthernetTxClockStop);
+    REQUIRE(config.macConfiguration == MAC_CONFIGURATION::MPBS_10);
+}
+
+TEST_CASE("interruptVectors", "[Fields]")
+{
+    EEPROM_CONFIG config{};
+    config.msiMultipleMessageCapable = MSI_MULTIPLE_MESSAGE_CAPABLE::VECTORS_16;
+    config.msixTableSize = MSIX_TABLE_SIZE::VECTORS_8;
+    EEPROM eeprom = createEEPROM(config);
+    REQUIRE(eeprom.msiCapabilities == 0x40);
+    REQUIRE(eeprom.deviceCapabilities_2 == 0x70);
+    REQUIRE(eeprom.byte7 == 0x40);
+    REQUIRE(eeprom.l1PMSubstatesCapabilitesEnable == 0x16);
+    REQUIRE(isEnabled(fields::msiMultipleMessageCapable, eeprom));
+    REQUIRE(isEnabled(fields::msixTableSize, eeprom));
+
+    const EEPROM_CONFIG decoded = eepromConfigToEEPROM(eeprom);
+    REQUIRE(decoded.msiMultipleMessageCapable == MSI_MULTIPLE_MESSAGE_CAPABLE::VECTORS_16);
+    REQUIRE(decoded.msixTableSize == MSIX_TABLE_SIZE::VECTORS_8);
+
+    // a single vector is the hardware default, the override is dropped
+    config.msiMultipleMessageCapable = MSI_MULTIPLE_MESSAGE_CAPABLE::VECTORS_1;
+    encodeField(fields::msiMultipleMessageCapable, config, eeprom);
+    REQUIRE(eeprom.msiCapabilities == 0x00);
+    REQUIRE(eeprom.byte7 == 0x00);
+    REQUIRE(isEnabled(fields::msixTableSize, eeprom));
+}
+
+TEST_CASE("latencyFields", "[Fields]")
+{
+    EEPROM_CONFIG config{};
+    config.clockPowerManagement = true;
+    config.l0sAcceptableLatency = L0S_ACCEPTABLE_LATENCY::MICRO_SECONDS_1;
+    config.l1AcceptableLatency = L1_ACCEPTABLE_LATENCY::NO_LIMIT;
+    config.l0sExitLatency = L0S_EXIT_LATENCY::BELOW_NANO_SECONDS_512;
+    config.l1ExitLatency = L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_8;
+    const EEPROM eeprom = createEEPROM(config);
+    REQUIRE(eeprom.endpointAcceptableLatency == 0x74);
+    REQUIRE(eeprom.deviceCapabilities_1 == 0xb3);
+    REQUIRE(eeprom.byte7 == 0x80);
+    // 11 is clock power management
+    REQUIRE(eeprom.deviceCapabilitiesEnable_1_2 == 0x0f);
+
+    const EEPROM_CONFIG decoded = eepromConfigToEEPROM(eeprom);
+    REQUIRE(decoded.l0sAcceptableLatency == config.l0sAcceptableLatency);
+    REQUIRE(decoded.l1AcceptableLatency == config.l1AcceptableLatency);
+    REQUIRE(decoded.l0sExitLatency == config.l0sExitLatency);
+    REQUIRE(decoded.l1ExitLatency == config.l1ExitLatency);
+    REQUIRE(decoded.clockPowerManagement);
+}
+
+TEST_CASE("l12Timing", "[Fields]")
+{
+    EEPROM_CONFIG config{};
+    // requested, encoded
+    const std::vector<std::pair<uint32_t, uint32_t>> tPowerOn{
+        { 0, 0 },     { 1, 2 },     { 4, 4 },     { 61, 62 },     { 62, 62 },
+        { 63, 70 },   { 310, 310 }, { 311, 400 }, { 3001, 3100 }, { 3100, 3100 },
+    };
+    for (const auto& [requested, encoded] : tPowerOn)
+    {
+        INFO(requested);
+        setTPowerOn(config, requested);
+        REQUIRE(tPowerOnMicroSeconds(config) == encoded);
+    }
+    REQUIRE(config.tPowerOnValue == 31);
+    REQUIRE(config.tPowerOnScale == T_POWER_ON_SCALE::MICRO_SECONDS_100);
+    REQUIRE_THROWS_WITH(setTPowerOn(config, t_power_on_max + 1),
+                        ifm::error_type(ifm::EEPROM_VALUE_OUT_OF_RANGE).what());
+    REQUIRE(tPowerOnMicroSeconds(config) == t_power_on_max);
+
+    setCommonModeRestoreTime(config, 40);
+    REQUIRE_THROWS_WITH(setCommonModeRestoreTime(config, common_mode_restore_time_max + 1),
+                        ifm::error_type(ifm::EEPROM_VALUE_OUT_OF_RANGE).what());
+    setTPowerOn(config, 63);
+    REQUIRE(l12ExitMicroSeconds(config) == 110);
+
+    const EEPROM eeprom = createEEPROM(config);
+    REQUIRE(eeprom.portCommonModeRestoreTime == 40);
+    REQUIRE(eeprom.portTPowerOn == 0x47);
+    REQUIRE(eeprom.l1PMSubstatesCapabilitesEnable == 0x94);
+    REQUIRE(eeprom.aspmConfigEnable == 0x03);
+    REQUIRE(l12ExitMicroSeconds(eepromConfigToEEPROM(eeprom)) == 110);
+}
+
+namespace {
+constexpr EEPROM_CONFIG goldenConfig()
+{
+    EEPROM_CONFIG config{};
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    config.mac = { 0x00, 0x02, 0x01, 0x23, 0x10, 0x55 };
+    return config;
+}
+
+constexpr EEPROM golden_eeprom = createEEPROMConstexpr(goldenConfig());
+static_assert(golden_eeprom.magic == static_cast<Byte>(EEPROM_MAGIC::EEPROM_MAC));
+static_assert(golden_eeprom.l1PMSubstatesCapabilitesEnable == 0x14);
+static_assert(golden_eeprom.macConfig1 == 0xb8);
+static_assert(golden_eeprom.ledConfig2 == bigEndian(0xe680));
+static_assert(eepromConfigToEEPROMConstexpr(golden_eeprom).ledConfig[1].control
+              == LED_CONTROL::DUPLEX_COLLISION);
+// encodeEEPROM and decodeEEPROM are noexcept, the codec they are built on must not throw either
+static_assert(noexcept(createEEPROMConstexpr(std::declval<const EEPROM_CONFIG&>())));
+static_assert(noexcept(eepromConfigToEEPROMConstexpr(std::declval<const EEPROM&>())));
+}  // namespace
+
+TEST_CASE("constexprImage", "[Fields]")
+{
+    std::ifstream file("files/00-02-01-23-10-55-pad.bin", std::ios::binary);
+    std::array<char, sizeof(EEPROM)> bytes{};
+    REQUIRE(file.read(bytes.data(), bytes.size()));
+    REQUIRE(std::memcmp(bytes.data(), &golden_eeprom, sizeof(EEPROM)) == 0);
+}
+
+TEST_CASE("benchmark codec", "[.][benchmark]")
+{
+    const EEPROM_CONFIG config = gs_testFilesVector.back().second;
+    const EEPROM eeprom = createEEPROM(config);
+
+    BENCHMARK("createEEPROM") { return createEEPROM(config); };
+    BENCHMARK("eepromConfigToEEPROM") { return eepromConfigToEEPROM(eeprom); };
+}
@@ -0,0 +1,66 @@
+/** @file 023-testErrorCode.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "shared.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+
+TEST_CASE("errorCategory", "[ErrorCode]")
+{
+    const std::error_code error = ifm::make_error_code(ifm::EEPROM_INVALID_MAGIC);
+    REQUIRE(error);
+    REQUIRE(error.value() == ifm::EEPROM_INVALID_MAGIC);
+    REQUIRE(std::string(error.category().name()) == "lan7430conf");
+    REQUIRE(error.message() == ifm::error_type(ifm::EEPROM_INVALID_MAGIC).what());
+}
+
+TEST_CASE("encodeIntoBuffer", "[ErrorCode]")
+{
+    for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
+    {
+        EepromBytes bytes{};
+        REQUIRE(!encodeEEPROM(eepromConfig, bytes));
+
+        const EEPROM eeprom = createEEPROM(eepromConfig);
+        REQUIRE(std::memcmp(bytes.data(), &eeprom, sizeof(EEPROM)) == 0);
+        REQUIRE(!validateEEPROM(bytes));
+
+        EEPROM_CONFIG decoded{};
+        REQUIRE(!decodeEEPROM(bytes, decoded));
+        const EEPROM reencoded = createEEPROM(decoded);
+        REQUIRE(std::memcmp(&reencoded, &eeprom, sizeof(EEPROM)) == 0);
+    }
+}
+
+TEST_CASE("encodeInvalidMac", "[ErrorCode]")
+{
+    EEPROM_CONFIG config;
+    config.mac = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+    EepromBytes bytes{};
+    REQUIRE(encodeEEPROM(config, bytes) == ifm::make_error_code(ifm::MAC_ADDRESS_INVALID));
+    // the buffer is left untouched on error
+    REQUIRE(bytes == EepromBytes{});
+}
+
+TEST_CASE("decodeInvalidMagic", "[ErrorCode]")
+{
+    EepromBytes bytes{};
+    REQUIRE(!encodeEEPROM({}, bytes));
+    bytes[0] = 0x42;
+
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_OTP2;
+    REQUIRE(validateEEPROM(bytes) == ifm::make_error_code(ifm::EEPROM_INVALID_MAGIC));
+    REQUIRE(decodeEEPROM(bytes, config) == ifm::make_error_code(ifm::EEPROM_INVALID_MAGIC));
+    REQUIRE(config.magic == EEPROM_MAGIC::EEPROM_OTP2);
+}
@@ -0,0 +1,114 @@
+/** @file 024-testEepromFile.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/eepromfile.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "shared.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("mapTestFiles", "[EepromFile]")
+{
+    for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
+    {
+        const EepromFile file(eepromFilePath);
+        REQUIRE(file.size() == std::filesystem::file_size(eepromFilePath));
+        REQUIRE(static_cast<EEPROM_MAGIC>(file.eeprom().magic) == eepromConfig.magic);
+        REQUIRE(file.eeprom().mac == eepromConfig.mac);
+        REQUIRE(eepromConfigToEEPROM(file.eeprom()).obffSupport == eepromConfig.obffSupport);
+    }
+}
+
+TEST_CASE("shortFileReadsAsZero", "[EepromFile]")
+{
+    const std::string filePath = "files/00-80-0F-74-30-01-default.bin";
+    const EepromFile file(filePath);
+    REQUIRE(file.size() == 255);
+
+    const auto* bytes = reinterpret_cast<const Byte*>(&file.eeprom());
+    REQUIRE(std::all_of(bytes + 255, bytes + sizeof(EEPROM), [](Byte b) { return b == 0; }));
+}
+
+TEST_CASE("mapInvalidFiles", "[EepromFile]")
+{
+    REQUIRE_THROWS_WITH(EepromFile(""), ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+    REQUIRE_THROWS_WITH(EepromFile("files/does-not-exist.bin"),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-eepromfile.bin").string();
+    {
+        std::ofstream out(filePath, std::ios::binary);
+        out << "too short";
+    }
+    REQUIRE_THROWS_WITH(EepromFile(filePath), ifm::error_type(ifm::EEPROM_WRONG_SIZE).what());
+
+    EEPROM eeprom = readEEPROM("files/00-02-01-23-10-55-pad.bin");
+    eeprom.magic = 0x42;
+    writeRawEEPROM(filePath, eeprom);
+    REQUIRE_THROWS_WITH(EepromFile(filePath), ifm::error_type(ifm::EEPROM_INVALID_MAGIC).what());
+}
+
+TEST_CASE("patchPreservesUnknownBits", "[EepromFile]")
+{
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-patch.bin").string();
+    std::filesystem::copy_file("files/00-80-0F-74-30-01-random.bin",
+                               filePath,
+                               std::filesystem::copy_options::overwrite_existing);
+    {
+        // a bit of a register this library doesn't model
+        std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(0x13);
+        file.put(char(0xa5));
+    }
+    std::array<char, 255> before{};
+    std::ifstream(filePath, std::ios::binary).read(before.data(), before.size());
+
+    size_t written = patchEEPROM(
+        filePath, [](EepromRef& ref) { ref.set(fields::led2Control, LED_CONTROL::FORCE_LED_ON); });
+    REQUIRE(written == 1);
+    REQUIRE(std::filesystem::file_size(filePath) == 255);
+
+    std::array<char, 255> after{};
+    std::ifstream(filePath, std::ios::binary).read(after.data(), after.size());
+    for (size_t i = 0; i < after.size(); ++i)
+    {
+        INFO("byte " << i);
+        REQUIRE((i == 0x1e || after[i] == before[i]));
+    }
+    REQUIRE(after[0x13] == char(0xa5));
+    REQUIRE(EepromView(EepromFile(filePath).eeprom()).get(fields::led2Control)
+            == LED_CONTROL::FORCE_LED_ON);
+
+    // nothing changes, nothing is written
+    written = patchEEPROM(
+        filePath, [](EepromRef& ref) { ref.set(fields::led2Control, LED_CONTROL::FORCE_LED_ON); });
+    REQUIRE(written == 0);
+}
+
+TEST_CASE("patchInvalidEdit", "[EepromFile]")
+{
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-patch-invalid.bin").string();
+    std::filesystem::copy_file("files/00-02-01-23-10-55-pad.bin",
+                               filePath,
+                               std::filesystem::copy_options::overwrite_existing);
+
+    REQUIRE_THROWS_WITH(patchEEPROM(filePath, [](EepromRef& ref) { ref.setMac({}); }),
+                        ifm::error_type(ifm::MAC_ADDRESS_INVALID).what());
+    REQUIRE(readEEPROM(filePath).mac == stringToMac("00-02-01-23-10-55"));
+    REQUIRE_THROWS_WITH(patchEEPROM("files/does-not-exist.bin", [](EepromRef&) {}),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+}
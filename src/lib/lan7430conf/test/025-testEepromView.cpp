@@ -0,0 +1,96 @@
+/** @file 025-testEepromView.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/eepromfile.hpp"
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "shared.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+
+namespace {
+constexpr EEPROM default_eeprom = createEEPROMConstexpr({});
+static_assert(EepromView(default_eeprom).get(fields::led1Control) == LED_CONTROL::DUPLEX_COLLISION);
+static_assert(EepromView(default_eeprom).enabled(fields::pciPML12Support));
+static_assert(!EepromView(default_eeprom).enabled(fields::subsystemID));
+}  // namespace
+
+TEST_CASE("viewDecodesSingleFields", "[EepromView]")
+{
+    for (const auto& [eepromFilePath, eepromConfig] : gs_testFilesVector)
+    {
+        const EepromFile file(eepromFilePath);
+        const EepromView view(file.eeprom());
+        REQUIRE(view.magic() == eepromConfig.magic);
+        REQUIRE(view.mac() == eepromConfig.mac);
+        forEachField([&, &expected = eepromConfig](const auto& field) {
+            INFO(eepromFilePath << ": " << field.name);
+            REQUIRE(view.get(field) == field.member(expected));
+        });
+    }
+}
+
+TEST_CASE("refTouchesOnlyFieldBits", "[EepromView]")
+{
+    EepromBytes bytes;
+    bytes.fill(0x5a);
+    EepromRef ref(bytes);
+
+    SECTION("value without enable bit")
+    {
+        ref.set(fields::led2Control, LED_CONTROL::FORCE_LED_ON);
+
+        EepromBytes expected;
+        expected.fill(0x5a);
+        expected[0x1e] = 0x5f;  // big endian, led 2 is the low nibble of the first byte
+        REQUIRE(bytes == expected);
+        REQUIRE(ref.get(fields::led2Control) == LED_CONTROL::FORCE_LED_ON);
+    }
+    SECTION("value with enable bit")
+    {
+        ref.set(fields::obffSupport, OBFF_SUPPORT::NOT_SUPPORTED);
+
+        EepromBytes expected;
+        expected.fill(0x5a);
+        expected[0x14] = 0x52;  // bits 2:3
+        expected[0x09] = 0x5a;  // enable bit 16 is bit 0 of 0x09, already cleared
+        REQUIRE(bytes == expected);
+        REQUIRE(!ref.enabled(fields::obffSupport));
+
+        ref.set(fields::obffSupport, OBFF_SUPPORT::WAKE_MESSAGE_SIGNALING);
+        expected[0x14] = 0x5e;
+        expected[0x09] = 0x5b;
+        REQUIRE(bytes == expected);
+        REQUIRE(ref.enabled(fields::obffSupport));
+    }
+    SECTION("magic and mac")
+    {
+        ref.setMagic(EEPROM_MAGIC::EEPROM_OTP1);
+        ref.setMac({ 0x00, 0x02, 0x01, 0x23, 0x10, 0x55 });
+        REQUIRE(bytes[0] == 0xf3);
+        REQUIRE(bytes[1] == 0x00);
+        REQUIRE(bytes[6] == 0x55);
+        REQUIRE(bytes[7] == 0x5a);
+    }
+}
+
+TEST_CASE("refMatchesCreateEEPROM", "[EepromView]")
+{
+    const EEPROM_CONFIG config = gs_testFilesVector.back().second;
+
+    EEPROM eeprom = createEEPROM({});
+    EepromRef ref(eeprom);
+    ref.setMagic(config.magic);
+    ref.setMac(config.mac);
+    forEachField([&](const auto& field) { ref.set(field, field.member(config)); });
+
+    const EEPROM expected = createEEPROM(config);
+    REQUIRE(std::memcmp(&eeprom, &expected, sizeof(EEPROM)) == 0);
+}
@@ -0,0 +1,193 @@
+/** @file 026-testProfile.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/profile.hpp"
+#include "lan7430conf/stream.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string profilePath()
+{
+    return std::filesystem::temp_directory_path().append("lan7430-profile.json").string();
+}
+}  // namespace
+
+TEST_CASE("lowLatencyProfile", "[Profile]")
+{
+    EEPROM_CONFIG config{};
+    config.clockPowerManagement = true;
+    config.ltrMechanismSupport = true;
+    config.obffSupport = OBFF_SUPPORT::MESSAGE_SIGNALING;
+    // aspmL11Support stays false, so its override bit is cleared
+    config.pciPML11Support = true;
+    config.l1PMSubstatesSupported = true;
+    config.energyEfficientEthernetTxClockStop = true;
+    EEPROM eeprom = createEEPROM(config);
+    // 0x13 is reserved, it must survive the profile
+    eeprom.byte19 = 0x5a;
+
+    EepromRef ref(eeprom);
+    const ConfigProfile profile = findProfile("low-latency");
+    const std::vector<FieldChange> changes = applyProfile(profile, ref);
+    std::vector<std::string> names;
+    std::vector<std::string> overridden;
+    for (const auto& change : changes)
+    {
+        REQUIRE(change.after == 0);
+        REQUIRE((change.before != 0 || change.overridden));
+        names.push_back(change.name);
+        if (change.overridden)
+        {
+            overridden.push_back(change.name);
+        }
+    }
+    REQUIRE(names
+            == std::vector<std::string>{ "clockPowerManagement",
+                                         "ltrMechanismSupport",
+                                         "obffSupport",
+                                         "pciPML12Support",
+                                         "pciPML11Support",
+                                         "aspmL12Support",
+                                         "aspmL11Support",
+                                         "l1PMSubstatesSupported",
+                                         "energyEfficientEthernet",
+                                         "energyEfficientEthernetTxClockStop" });
+    // the override bits of the other fields were already set by their non-zero value
+    REQUIRE(overridden == std::vector<std::string>{ "aspmL11Support" });
+    REQUIRE(eeprom.byte19 == 0x5a);
+
+    // the features are forced off, not left to the hardware defaults
+    REQUIRE(ref.enabled(fields::clockPowerManagement));
+    REQUIRE(ref.enabled(fields::ltrMechanismSupport));
+    REQUIRE(ref.enabled(fields::obffSupport));
+    REQUIRE(ref.enabled(fields::pciPML12Support));
+    REQUIRE(ref.enabled(fields::pciPML11Support));
+    REQUIRE(ref.enabled(fields::aspmL12Support));
+    REQUIRE(ref.enabled(fields::aspmL11Support));
+    REQUIRE(ref.enabled(fields::l1PMSubstatesSupported));
+    // 0x07 - 0x0a: bits 11, 15, 16 and 18 - 22
+    REQUIRE((eeprom.deviceCapabilitiesEnable_1_2 & 0x88) == 0x88);
+    REQUIRE((eeprom.l1PMSubstatesCapabilitesEnable & 0x7d) == 0x7d);
+
+    // the remaining fields are the same as if the config had been encoded
+    EEPROM_CONFIG expected = config;
+    expected.clockPowerManagement = false;
+    expected.ltrMechanismSupport = false;
+    expected.obffSupport = OBFF_SUPPORT::NOT_SUPPORTED;
+    expected.pciPML12Support = false;
+    expected.pciPML11Support = false;
+    expected.aspmL12Support = false;
+    expected.aspmL11Support = false;
+    expected.l1PMSubstatesSupported = false;
+    expected.energyEfficientEthernet = false;
+    expected.energyEfficientEthernetTxClockStop = false;
+    EEPROM expectedEeprom = createEEPROM(expected);
+    expectedEeprom.byte19 = 0x5a;
+    EepromRef expectedRef(expectedEeprom);
+    expectedRef.force(fields::clockPowerManagement, false);
+    expectedRef.force(fields::ltrMechanismSupport, false);
+    expectedRef.force(fields::obffSupport, OBFF_SUPPORT::NOT_SUPPORTED);
+    expectedRef.force(fields::pciPML12Support, false);
+    expectedRef.force(fields::pciPML11Support, false);
+    expectedRef.force(fields::aspmL12Support, false);
+    expectedRef.force(fields::aspmL11Support, false);
+    expectedRef.force(fields::l1PMSubstatesSupported, false);
+    REQUIRE(std::memcmp(&eeprom, &expectedEeprom, sizeof(EEPROM)) == 0);
+
+    // applying it again changes nothing
+    REQUIRE(applyProfile(profile, ref).empty());
+
+    // a field that changes to 0 keeps the override bit the profile asks for
+    ConfigProfile ltrOff{ "ltr-off", "", R"({"ltrMechanismSupport": false})", {} };
+    ConfigProfile ltrForced = ltrOff;
+    ltrForced.overrides = { "ltrMechanismSupport" };
+    EEPROM ltr = createEEPROM(config);
+    EepromRef ltrRef(ltr);
+    REQUIRE(applyProfile(ltrOff, ltrRef).size() == 1);
+    REQUIRE_FALSE(ltrRef.enabled(fields::ltrMechanismSupport));
+    ltr = createEEPROM(config);
+    REQUIRE(applyProfile(ltrForced, ltrRef).size() == 1);
+    REQUIRE(ltrRef.enabled(fields::ltrMechanismSupport));
+    REQUIRE_FALSE(ltrRef.get(fields::ltrMechanismSupport));
+}
+
+TEST_CASE("profileFile", "[Profile]")
+{
+    std::ofstream(profilePath()) << R"({"mac": "00-02-01-23-10-55", "subsystemID": 4660})";
+    const ConfigProfile profile = findProfile(profilePath());
+    REQUIRE(profile.name == "lan7430-profile");
+
+    EEPROM eeprom = createEEPROM({});
+    EepromRef ref(eeprom);
+    const std::vector<FieldChange> changes = applyProfile(profile, ref);
+    REQUIRE(changes.size() == 2);
+    REQUIRE(changes[0].name == "mac");
+    REQUIRE(changes[0].before == macToInteger(EEPROM_CONFIG{}.mac));
+    REQUIRE(changes[0].after == macToInteger(stringToMac("00-02-01-23-10-55")));
+    REQUIRE(changes[1].name == "subsystemID");
+    REQUIRE(changes[1].after == 0x1234);
+    REQUIRE(eepromConfigToEEPROM(eeprom).subsystemID == 0x1234);
+
+    // a capability the file turns off is overridden like in the built in profiles
+    std::ofstream(profilePath())
+        << R"({"ltrMechanismSupport": false, "clockPowerManagement": false, "subsystemID": 0})";
+    const ConfigProfile disabling = findProfile(profilePath());
+    REQUIRE(disabling.description.find(profilePath()) != std::string::npos);
+    REQUIRE(disabling.overrides
+            == std::vector<std::string>{ "clockPowerManagement", "ltrMechanismSupport" });
+
+    EEPROM random = readEEPROM("files/00-80-0F-74-30-01-random.bin");
+    REQUIRE((random.deviceCapabilitiesEnable_1_2 & 0x88) == 0x88);
+    EepromRef randomRef(random);
+    const bool ltrBefore = randomRef.get(fields::ltrMechanismSupport);
+    const bool clockBefore = randomRef.get(fields::clockPowerManagement);
+    const std::vector<FieldChange> disabled = applyProfile(disabling, randomRef);
+    // subsystemID is a number, it changes from its random value to 0 without being forced
+    REQUIRE(disabled.size() == 1 + static_cast<size_t>(ltrBefore) + static_cast<size_t>(clockBefore));
+    REQUIRE((random.deviceCapabilitiesEnable_1_2 & 0x88) == 0x88);
+    REQUIRE(randomRef.enabled(fields::clockPowerManagement));
+    REQUIRE(randomRef.enabled(fields::ltrMechanismSupport));
+    REQUIRE_FALSE(randomRef.get(fields::clockPowerManagement));
+    REQUIRE_FALSE(randomRef.get(fields::ltrMechanismSupport));
+
+    // invalid settings are rejected when the profile is loaded
+    std::ofstream(profilePath()) << R"({"subsystemId": 4660})";
+    REQUIRE_THROWS_WITH(findProfile(profilePath()),
+                        ifm::error_type(ifm::STREAM_UNKNOWN_MEMBER).what());
+    std::filesystem::remove(profilePath());
+    REQUIRE_THROWS_WITH(findProfile(profilePath()), ifm::error_type(ifm::PROFILE_UNKNOWN).what());
+    REQUIRE_THROWS_WITH(findProfile("high-latency"), ifm::error_type(ifm::PROFILE_UNKNOWN).what());
+}
+
+TEST_CASE("builtinProfilesAreValid", "[Profile]")
+{
+    for (const auto& profile : builtinProfiles())
+    {
+        INFO(profile.name);
+        EEPROM_CONFIG config{};
+        REQUIRE_NOTHROW(applyConfigRecord(profile.settings, config));
+        // only fields with an override bit can be overridden
+        for (const auto& name : profile.overrides)
+        {
+            INFO(name);
+            bool found = false;
+            forEachField([&](const auto& field) {
+                found = found || (name == field.name && field.enableBit != no_enable_bit);
+            });
+            REQUIRE(found);
+        }
+    }
+}
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <iostream>
 #include <bitset>
+#include <vector>
 
 TEMPLATE_TEST_CASE("test set individual bits",
                    "[Byte][setBits]",
@@ -251,3 +252,125 @@ TEMPLATE_TEST_CASE("test set bitmask random",
         REQUIRE(allZeros == static_cast<TestType>(randOred));
     }
 }
+
+static_assert(bitmask<Byte, 0, 7>() == 0xff);
+static_assert(bitmask<Byte16, 4, 7>() == 0x00f0);
+static_assert(bitmask<uint64_t, 0, 63>() == ~uint64_t(0));
+static_assert(bitmask<int8_t, 7>() == int8_t(0x80));
+static_assert(getBits<Byte, 4, 7>(Byte(0xa5)) == 0xa);
+static_assert(getBits<bool, 15>(Byte16(0x8000)));
+
+TEMPLATE_TEST_CASE("test compile time bits",
+                   "[Byte][getBits][setBits]",
+                   Byte,
+                   Byte16,
+                   uint32_t,
+                   uint64_t,
+                   int8_t,
+                   int16_t,
+                   int32_t,
+                   int64_t)
+{
+    TestType value = 0b0;
+
+    SECTION("set bits [0:0]")
+    {
+        setBits<0>(value, true);
+        REQUIRE(getBits<bool, 0>(value));
+        REQUIRE(value == TestType(0b1));
+    }
+    SECTION("set bits [1:5]")
+    {
+        setBits<1, 5>(value, 0b1010);
+        REQUIRE(getBits<TestType, 1, 5>(value) == TestType(0b1010));
+        REQUIRE(value == TestType(0b00010100));
+    }
+    SECTION("set bits clears the range first")
+    {
+        value = ~TestType(0);
+        setBits<2, 3>(value, 0b01);
+        REQUIRE(getBits<TestType, 2, 3>(value) == TestType(0b01));
+        REQUIRE(value == TestType(~TestType(0b1000)));
+    }
+    SECTION("set bits ignores bits exceeding the range")
+    {
+        setBits<4, 5>(value, 0xff);
+        REQUIRE(value == TestType(0b00110000));
+    }
+    SECTION("set bits enum")
+    {
+        setBits<4, 7>(value, LED_CONTROL::SERIAL_MODE);
+        REQUIRE(getBits<LED_CONTROL, 4, 7>(value) == LED_CONTROL::SERIAL_MODE);
+    }
+    SECTION("set most significant bit")
+    {
+        constexpr uint32_t msb = sizeof(TestType) * 8 - 1;
+        setBits<msb>(value, 1);
+        REQUIRE(getBits<bool, msb>(value));
+        REQUIRE(value == bitmask<TestType, msb>());
+    }
+}
+
+TEST_CASE("benchmark bits", "[.][benchmark]")
+{
+    // the runtime variants get the positions from a table, like the codec used to
+    struct Range
+    {
+        uint32_t start;
+        uint32_t end;
+    };
+    static const Range ranges[] = { { 0, 3 }, { 4, 7 }, { 8, 11 }, { 12, 15 } };
+
+    std::vector<Byte16> words(4096);
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        words[i] = static_cast<Byte16>(i * 0x9e37);
+    }
+
+    BENCHMARK("getBitmask")
+    {
+        uint32_t sum = 0;
+        for (const auto word : words)
+        {
+            for (const auto& range : ranges)
+            {
+                sum += getBitmask<Byte16>(word, range.start, range.end);
+            }
+        }
+        return sum;
+    };
+    BENCHMARK("getBits")
+    {
+        uint32_t sum = 0;
+        for (const auto word : words)
+        {
+            sum += getBits<Byte16, 0, 3>(word) + getBits<Byte16, 4, 7>(word)
+                   + getBits<Byte16, 8, 11>(word) + getBits<Byte16, 12, 15>(word);
+        }
+        return sum;
+    };
+    BENCHMARK("setBitmask")
+    {
+        Byte16 result = 0;
+        for (const auto word : words)
+        {
+            for (const auto& range : ranges)
+            {
+                setBitmask<Byte16>(result, range.start, range.end, word);
+            }
+        }
+        return result;
+    };
+    BENCHMARK("setBits")
+    {
+        Byte16 result = 0;
+        for (const auto word : words)
+        {
+            setBits<0, 3>(result, word);
+            setBits<4, 7>(result, word);
+            setBits<8, 11>(result, word);
+            setBits<12, 15>(result, word);
+        }
+        return result;
+    };
+}
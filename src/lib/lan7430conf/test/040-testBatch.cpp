@@ -0,0 +1,81 @@
+/** @file 040-testBatch.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/batch.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+TEST_CASE("batchFileName", "[Batch]")
+{
+    REQUIRE_THAT(batchFileName(stringToMac("00:02:01:23:10:58")),
+                 Catch::Equals("00-02-01-23-10-58-pad.bin"));
+}
+
+TEST_CASE("writeBatch", "[Batch]")
+{
+    const auto directory = std::filesystem::temp_directory_path() / "lan7430-batch";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    const EEPROM eeprom = createEEPROM(config);
+    const Mac macStart = stringToMac("00-02-01-23-10-F0");
+    const uint64_t count = 1000;
+
+    REQUIRE_NOTHROW(writeEEPROMBatch(directory.string(), eeprom, macStart, count, 7));
+
+    REQUIRE(std::distance(std::filesystem::directory_iterator(directory),
+                          std::filesystem::directory_iterator())
+            == count);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        const Mac mac = incrementMac(macStart, i);
+        EEPROM expected = eeprom;
+        expected.mac = mac;
+
+        EEPROM written;
+        REQUIRE_NOTHROW(written = readEEPROM((directory / batchFileName(mac)).string()));
+        REQUIRE(std::equal(reinterpret_cast<const Byte*>(&expected),
+                           reinterpret_cast<const Byte*>(&expected) + sizeof(EEPROM),
+                           reinterpret_cast<const Byte*>(&written)));
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("writeBatchMoreThreadsThanFiles", "[Batch]")
+{
+    const auto directory = std::filesystem::temp_directory_path() / "lan7430-batch-small";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    REQUIRE_NOTHROW(writeEEPROMBatch(
+        directory.string(), createEEPROM({}), stringToMac("00-02-01-23-10-55"), 2, 16));
+    REQUIRE(std::filesystem::exists(directory / "00-02-01-23-10-55-pad.bin"));
+    REQUIRE(std::filesystem::exists(directory / "00-02-01-23-10-56-pad.bin"));
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("writeBatchErrors", "[Batch]")
+{
+    REQUIRE_THROWS_WITH(writeEEPROMBatch("/tmp/this/is/some/random/path/to/nowhere",
+                                         createEEPROM({}),
+                                         stringToMac("00-02-01-23-10-55"),
+                                         10),
+                        ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST).what());
+    REQUIRE_THROWS_WITH(writeEEPROMBatch(std::filesystem::temp_directory_path().string(),
+                                         createEEPROM({}),
+                                         stringToMac("FF-FF-FF-FF-FF-F0"),
+                                         0x20),
+                        ifm::error_type(ifm::MAC_ADDRESS_OVERFLOW).what());
+}
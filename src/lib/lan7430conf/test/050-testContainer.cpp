@@ -0,0 +1,102 @@
+/** @file 050-testContainer.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/container.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+namespace {
+std::vector<EEPROM> createImages(const Mac& macStart, size_t count)
+{
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    std::vector<EEPROM> images(count, createEEPROM(config));
+    for (size_t i = 0; i < count; ++i)
+    {
+        images[i].mac = incrementMac(macStart, i);
+    }
+    return images;
+}
+}  // namespace
+
+TEST_CASE("writeAndReadContainer", "[Container]")
+{
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-container.l7c").string();
+    const Mac macStart = stringToMac("00-02-01-23-10-00");
+    // more images than IOV_MAX, shuffled, so the images are written in several writev calls
+    std::vector<EEPROM> images = createImages(macStart, 3000);
+    std::shuffle(images.begin(), images.end(), std::mt19937{ 42 });
+
+    REQUIRE_NOTHROW(writeEEPROMContainer(filePath, images));
+    REQUIRE(EepromContainer::isContainer(filePath));
+    // image size + index + header, rounded up to the image size
+    REQUIRE(std::filesystem::file_size(filePath) == 3000 * 512 + 47 * 512);
+
+    const EepromContainer container(filePath);
+    REQUIRE(container.size() == images.size());
+    for (uint64_t i = 0; i < container.size(); ++i)
+    {
+        REQUIRE(container.macAt(i) == incrementMac(macStart, i));
+        REQUIRE(container.imageAt(i).mac == container.macAt(i));
+    }
+    for (const auto& image : images)
+    {
+        const EEPROM* found = container.find(image.mac);
+        REQUIRE(found != nullptr);
+        REQUIRE(std::memcmp(found, &image, sizeof(EEPROM)) == 0);
+
+        EEPROM read;
+        REQUIRE_NOTHROW(read = readEEPROM(filePath, image.mac));
+        REQUIRE(std::memcmp(&read, &image, sizeof(EEPROM)) == 0);
+    }
+
+    REQUIRE(container.find(stringToMac("00-02-01-23-0F-FF")) == nullptr);
+    REQUIRE(container.find(incrementMac(macStart, 3000)) == nullptr);
+    REQUIRE_THROWS_WITH(container.at(stringToMac("00-02-01-23-0F-FF")),
+                        ifm::error_type(ifm::CONTAINER_MAC_NOT_FOUND).what());
+    REQUIRE_THROWS_WITH(readEEPROM(filePath, stringToMac("AA-02-01-23-0F-FF")),
+                        ifm::error_type(ifm::CONTAINER_MAC_NOT_FOUND).what());
+}
+
+TEST_CASE("emptyContainer", "[Container]")
+{
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-empty.l7c").string();
+    REQUIRE_NOTHROW(writeEEPROMContainer(filePath, {}));
+
+    const EepromContainer container(filePath);
+    REQUIRE(container.size() == 0);
+    REQUIRE(container.find(stringToMac("00-02-01-23-10-55")) == nullptr);
+}
+
+TEST_CASE("containerDuplicateMac", "[Container]")
+{
+    std::vector<EEPROM> images = createImages(stringToMac("00-02-01-23-10-00"), 10);
+    images.push_back(images[3]);
+    REQUIRE_THROWS_WITH(
+        writeEEPROMContainer(
+            std::filesystem::temp_directory_path().append("lan7430-dup.l7c").string(), images),
+        ifm::error_type(ifm::CONTAINER_DUPLICATE_MAC).what());
+}
+
+TEST_CASE("invalidContainer", "[Container]")
+{
+    REQUIRE_FALSE(EepromContainer::isContainer("files/00-02-01-23-10-55-pad.bin"));
+    REQUIRE_THROWS_WITH(EepromContainer("files/00-02-01-23-10-55-pad.bin"),
+                        ifm::error_type(ifm::CONTAINER_INVALID).what());
+    REQUIRE_THROWS_WITH(EepromContainer("files/does-not-exist.l7c"),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+}
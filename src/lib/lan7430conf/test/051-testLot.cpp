@@ -0,0 +1,77 @@
+/** @file 051-testLot.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/lot.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <filesystem>
+
+TEST_CASE("writeAndReadLot", "[Lot]")
+{
+    const std::string filePath
+        = std::filesystem::temp_directory_path().append("lan7430-lot.l7l").string();
+
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    const EEPROM base = createEEPROM(config);
+
+    const Mac macStart = stringToMac("00-02-01-23-10-00");
+    EepromLot lot(base);
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        EEPROM image = base;
+        image.mac = incrementMac(macStart, i);
+        REQUIRE_NOTHROW(lot.add(image));
+    }
+    REQUIRE_NOTHROW(writeEEPROMLot(filePath, lot));
+    REQUIRE(EepromLot::isLot(filePath));
+    REQUIRE(std::filesystem::file_size(filePath)
+            == sizeof(EEPROM_LOT_HEADER) + sizeof(EEPROM) + 1000 * 6);
+
+    EepromLot read = readEEPROMLot(filePath);
+    REQUIRE(read.size() == lot.size());
+    REQUIRE(read.macs() == lot.macs());
+    for (size_t i = 0; i < read.size(); ++i)
+    {
+        EEPROM expected = base;
+        expected.mac = incrementMac(macStart, i);
+        const EEPROM image = read.image(i);
+        REQUIRE(std::memcmp(&image, &expected, sizeof(EEPROM)) == 0);
+    }
+
+    const EEPROM image = read.image(stringToMac("00-02-01-23-11-00"));
+    REQUIRE(image.mac == stringToMac("00-02-01-23-11-00"));
+    REQUIRE_THROWS_WITH(read.image(stringToMac("00-02-01-23-0F-FF")),
+                        ifm::error_type(ifm::LOT_IMAGE_NOT_FOUND).what());
+    REQUIRE_THROWS_WITH(read.image(1000), ifm::error_type(ifm::LOT_IMAGE_NOT_FOUND).what());
+}
+
+TEST_CASE("lotImageMismatch", "[Lot]")
+{
+    const EEPROM base = createEEPROM({});
+    EepromLot lot(base);
+
+    EEPROM_CONFIG config;
+    config.subsystemID = 0x1234;
+    EEPROM image = createEEPROM(config);
+    REQUIRE_THROWS_WITH(lot.add(image), ifm::error_type(ifm::LOT_IMAGE_MISMATCH).what());
+    REQUIRE(lot.size() == 0);
+}
+
+TEST_CASE("invalidLot", "[Lot]")
+{
+    REQUIRE_FALSE(EepromLot::isLot("files/00-02-01-23-10-55-pad.bin"));
+    REQUIRE_THROWS_WITH(readEEPROMLot("files/00-02-01-23-10-55-pad.bin"),
+                        ifm::error_type(ifm::LOT_INVALID).what());
+    REQUIRE_THROWS_WITH(readEEPROMLot("files/does-not-exist.l7l"),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+}
@@ -0,0 +1,135 @@
+/** @file 060-testLedger.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/ledger.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+std::string freshLedger(const std::string& name, const Mac& first, const Mac& last)
+{
+    const std::string filePath = std::filesystem::temp_directory_path().append(name).string();
+    std::filesystem::remove(filePath);
+    MacLedger::create(filePath, first, last);
+    return filePath;
+}
+}  // namespace
+
+TEST_CASE("ledgerAllocate", "[Ledger]")
+{
+    const std::string filePath = freshLedger("lan7430-ledger.l7m",
+                                             stringToMac("00-02-01-23-10-FE"),
+                                             stringToMac("00-02-01-23-11-01"));
+    {
+        MacLedger ledger(filePath);
+        REQUIRE(ledger.first() == stringToMac("00-02-01-23-10-FE"));
+        REQUIRE(ledger.last() == stringToMac("00-02-01-23-11-01"));
+        REQUIRE(ledger.remaining() == 4);
+        REQUIRE(ledger.allocate() == stringToMac("00-02-01-23-10-FE"));
+        REQUIRE(ledger.allocate() == stringToMac("00-02-01-23-10-FF"));
+        REQUIRE(ledger.remaining() == 2);
+    }
+    {
+        // a reopened ledger continues where the last one stopped
+        MacLedger ledger(filePath);
+        REQUIRE(ledger.allocate() == stringToMac("00-02-01-23-11-00"));
+        REQUIRE(ledger.allocate() == stringToMac("00-02-01-23-11-01"));
+        REQUIRE(ledger.remaining() == 0);
+        REQUIRE_THROWS_WITH(ledger.allocate(), ifm::error_type(ifm::LEDGER_EXHAUSTED).what());
+        REQUIRE_THROWS_WITH(ledger.allocate(), ifm::error_type(ifm::LEDGER_EXHAUSTED).what());
+    }
+    REQUIRE(std::filesystem::file_size(MacLedger::journalPath(filePath)) == 4 * sizeof(uint64_t));
+}
+
+TEST_CASE("ledgerRecoversFromJournal", "[Ledger]")
+{
+    const std::string filePath = freshLedger("lan7430-ledger-recover.l7m",
+                                             stringToMac("00-02-01-23-10-00"),
+                                             stringToMac("00-02-01-23-10-FF"));
+    {
+        MacLedger ledger(filePath);
+        for (int i = 0; i < 10; ++i)
+        {
+            ledger.allocate();
+        }
+    }
+
+    // simulate a lost update of the header by rolling the counter back to the start of the range
+    {
+        std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t next = macToInteger(stringToMac("00-02-01-23-10-00"));
+        file.seekp(offsetof(MAC_LEDGER_HEADER, next));
+        file.write(reinterpret_cast<const char*>(&next), sizeof(next));
+    }
+
+    MacLedger ledger(filePath);
+    REQUIRE(ledger.allocate() == stringToMac("00-02-01-23-10-0A"));
+}
+
+TEST_CASE("ledgerConcurrentAllocate", "[Ledger]")
+{
+    const std::string filePath = freshLedger("lan7430-ledger-concurrent.l7m",
+                                             stringToMac("00-02-01-23-10-00"),
+                                             stringToMac("00-02-01-23-13-FF"));
+
+    // every thread maps the ledger on its own, like separate processes would
+    constexpr int threadCount = 4;
+    constexpr int allocations = 100;
+    std::vector<std::vector<uint64_t>> allocated(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            MacLedger ledger(filePath);
+            for (int i = 0; i < allocations; ++i)
+            {
+                allocated[t].push_back(macToInteger(ledger.allocate()));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto& values : allocated)
+    {
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    REQUIRE(all.size() == threadCount * allocations);
+    REQUIRE(std::adjacent_find(all.begin(), all.end()) == all.end());
+    REQUIRE(all.front() == macToInteger(stringToMac("00-02-01-23-10-00")));
+    REQUIRE(all.back() == all.front() + threadCount * allocations - 1);
+}
+
+TEST_CASE("ledgerErrors", "[Ledger]")
+{
+    const std::string filePath = freshLedger("lan7430-ledger-errors.l7m",
+                                             stringToMac("00-02-01-23-10-00"),
+                                             stringToMac("00-02-01-23-10-FF"));
+    REQUIRE_THROWS_WITH(MacLedger::create(filePath,
+                                          stringToMac("00-02-01-23-10-00"),
+                                          stringToMac("00-02-01-23-10-FF")),
+                        ifm::error_type(ifm::FILE_CANT_WRITE).what());
+    REQUIRE_THROWS_WITH(MacLedger::create(filePath + ".range",
+                                          stringToMac("00-02-01-23-10-01"),
+                                          stringToMac("00-02-01-23-10-00")),
+                        ifm::error_type(ifm::LEDGER_INVALID_RANGE).what());
+    REQUIRE_THROWS_WITH(MacLedger("files/00-02-01-23-10-55-pad.bin"),
+                        ifm::error_type(ifm::LEDGER_INVALID).what());
+}
@@ -0,0 +1,102 @@
+/** @file 061-testAudit.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/audit.hpp"
+#include "lan7430conf/batch.hpp"
+#include "lan7430conf/container.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/lot.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string freshDirectory(const std::string& name)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path().append(name);
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+EEPROM createImage()
+{
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    return createEEPROM(config);
+}
+}  // namespace
+
+TEST_CASE("auditWithoutDuplicates", "[Audit]")
+{
+    const std::string directory = freshDirectory("lan7430-audit-unique");
+    writeEEPROMBatch(directory, createImage(), stringToMac("00-02-01-23-10-00"), 300, 4);
+    std::ofstream(directory + "/notes.txt") << "not an EEPROM";
+    // the size of an EEPROM, but no valid magic
+    std::ofstream(directory + "/zeros.bin") << std::string(base_eeprom_len, '\0');
+    // a truncated container is skipped instead of aborting the audit
+    const std::string containerPath = directory + "/truncated.l7c";
+    std::vector<EEPROM> images(2, createImage());
+    images[1].mac = stringToMac("00-02-01-23-20-00");
+    writeEEPROMContainer(containerPath, images);
+    std::filesystem::resize_file(containerPath, 64);
+
+    const MacAuditResult result = auditMacs({ directory }, 4);
+    REQUIRE(result.files == 303);
+    REQUIRE(result.images == 300);
+    REQUIRE_THAT(result.skipped,
+                 Catch::UnorderedEquals(std::vector<std::string>{
+                     directory + "/notes.txt", directory + "/zeros.bin", containerPath }));
+    REQUIRE(result.duplicates.empty());
+}
+
+TEST_CASE("auditFindsDuplicates", "[Audit]")
+{
+    const std::string directory = freshDirectory("lan7430-audit-duplicates");
+    const std::string batchDirectory = directory + "/batch";
+    std::filesystem::create_directory(batchDirectory);
+    writeEEPROMBatch(batchDirectory, createImage(), stringToMac("00-02-01-23-10-00"), 256);
+
+    // the container overlaps with the end of the batch, the lot with the container
+    std::vector<EEPROM> images(2, createImage());
+    images[0].mac = stringToMac("00-02-01-23-10-FF");
+    images[1].mac = stringToMac("00-02-01-23-11-00");
+    const std::string containerPath = directory + "/images.l7c";
+    writeEEPROMContainer(containerPath, images);
+
+    const std::string lotPath = directory + "/images.l7l";
+    const EepromLot lot(createImage(),
+                        { stringToMac("00-02-01-23-11-00"), stringToMac("00-02-01-23-11-01") });
+    writeEEPROMLot(lotPath, lot);
+
+    const MacAuditResult result = auditMacs({ batchDirectory, containerPath, lotPath });
+    REQUIRE(result.files == 258);
+    REQUIRE(result.images == 260);
+    REQUIRE(result.skipped.empty());
+    REQUIRE(result.duplicates.size() == 2);
+
+    REQUIRE(result.duplicates[0].mac == stringToMac("00-02-01-23-10-FF"));
+    REQUIRE_THAT(result.duplicates[0].locations,
+                 Catch::UnorderedEquals(std::vector<std::string>{
+                     batchDirectory + "/" + batchFileName(stringToMac("00-02-01-23-10-FF")),
+                     containerPath + "[0]" }));
+
+    REQUIRE(result.duplicates[1].mac == stringToMac("00-02-01-23-11-00"));
+    REQUIRE_THAT(result.duplicates[1].locations,
+                 Catch::UnorderedEquals(
+                     std::vector<std::string>{ containerPath + "[1]", lotPath + "[0]" }));
+}
+
+TEST_CASE("auditMissingPath", "[Audit]")
+{
+    REQUIRE_THROWS_WITH(auditMacs({ "/does/not/exist" }),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+}
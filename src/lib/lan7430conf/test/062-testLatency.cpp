@@ -0,0 +1,179 @@
+/** @file 062-testLatency.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/batch.hpp"
+#include "lan7430conf/container.hpp"
+#include "lan7430conf/eepromview.hpp"
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/latency.hpp"
+#include "lan7430conf/lot.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+std::string freshDirectory(const std::string& name)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path().append(name);
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+EEPROM_CONFIG defaultConfig()
+{
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    return config;
+}
+
+/// L1.2 with 70 us T_POWER_ON and 40 us Common_Mode_Restore_Time, EEE off
+EEPROM_CONFIG l12Config()
+{
+    EEPROM_CONFIG config = defaultConfig();
+    config.l1PMSubstatesSupported = true;
+    setTPowerOn(config, 63);
+    setCommonModeRestoreTime(config, 40);
+    config.l0sAcceptableLatency = L0S_ACCEPTABLE_LATENCY::MICRO_SECONDS_1;
+    config.l0sExitLatency = L0S_EXIT_LATENCY::ABOVE_MICRO_SECONDS_4;
+    config.l1AcceptableLatency = L1_ACCEPTABLE_LATENCY::NO_LIMIT;
+    config.l1ExitLatency = L1_EXIT_LATENCY::BELOW_MICRO_SECONDS_8;
+    config.aspmL1EntranceLatency = ASPM_L1_ENTRANCE_LATENCY::MICRO_SECONDS_32;
+    config.energyEfficientEthernet = false;
+    return config;
+}
+}  // namespace
+
+TEST_CASE("latencyFigures", "[Latency]")
+{
+    const LatencyFigures defaults = latencyFigures(createEEPROM(defaultConfig()));
+    REQUIRE(defaults.l0sEntrance == 1000);
+    REQUIRE(defaults.l1Entrance == 1000);
+    REQUIRE(defaults.l0sExit == 64);
+    REQUIRE(defaults.l1Exit == 1000);
+    REQUIRE(!defaults.l0sBlocked);
+    REQUIRE(!defaults.l1Blocked);
+    // L1.2 is supported by ASPM and PCI-PM, the L1 PM substates capability keeps the hardware
+    // default, which may support it
+    REQUIRE(defaults.l12Enabled);
+    REQUIRE(defaults.l12Exit == 1000);
+    // the speed is detected automatically, 100BASE-TX wakes slowest
+    REQUIRE(defaults.eeeWake == 30000);
+    REQUIRE(defaults.worstWake == 31000);
+    REQUIRE(defaults.defaults
+            == std::vector<std::string>{ "l0sAcceptableLatency",
+                                         "l1AcceptableLatency",
+                                         "l0sExitLatency",
+                                         "l1ExitLatency",
+                                         "clockPowerManagement",
+                                         "ltrMechanismSupport",
+                                         "pciPML11Support",
+                                         "aspmL11Support",
+                                         "l1PMSubstatesSupported",
+                                         "commonModeRestoreTime",
+                                         "tPowerOnValue" });
+
+    // L1.2 is only off if the override bit forces the capability off
+    EEPROM forcedOff = createEEPROM(defaultConfig());
+    EepromRef(forcedOff).force(fields::l1PMSubstatesSupported, false);
+    const LatencyFigures off = latencyFigures(forcedOff);
+    REQUIRE(!off.l12Enabled);
+    REQUIRE(off.l12Exit == 0);
+    REQUIRE(std::find(off.defaults.begin(), off.defaults.end(), "l1PMSubstatesSupported")
+            == off.defaults.end());
+
+    const LatencyFigures l12 = latencyFigures(createEEPROM(l12Config()));
+    REQUIRE(l12.l1Entrance == 32000);
+    REQUIRE(l12.l0sExit == latency_unbounded);
+    REQUIRE(l12.l0sBlocked);
+    REQUIRE(l12.l1Acceptable == latency_unbounded);
+    REQUIRE(l12.l12Enabled);
+    REQUIRE(l12.l12Exit == 8000 + 110000);
+    REQUIRE(l12.eeeWake == 0);
+    // L0s exceeds its acceptable latency and isn't enabled by the OS
+    REQUIRE(l12.worstWake == l12.l12Exit);
+    REQUIRE(l12.defaults
+            == std::vector<std::string>{
+                "clockPowerManagement", "ltrMechanismSupport", "pciPML11Support", "aspmL11Support" });
+
+    EEPROM_CONFIG config = l12Config();
+    config.l1AcceptableLatency = L1_ACCEPTABLE_LATENCY::MICRO_SECONDS_4;
+    config.energyEfficientEthernet = true;
+    config.automaticSpeedDetection = false;
+    config.macConfiguration = MAC_CONFIGURATION::MPBS_1000;
+    const LatencyFigures blocked = latencyFigures(createEEPROM(config));
+    REQUIRE(blocked.l1Blocked);
+    REQUIRE(blocked.eeeWake == 16500);
+    REQUIRE(blocked.worstWake == 16500);
+}
+
+TEST_CASE("checkLatencyBudget", "[Latency]")
+{
+    const LatencyFigures l12 = latencyFigures(createEEPROM(l12Config()));
+    REQUIRE(checkLatencyBudget(l12, {}).empty());
+
+    LatencyBudget budget;
+    budget.l0sExit = 64;
+    budget.l12Exit = 100000;
+    budget.worstWake = 100000;
+    REQUIRE(checkLatencyBudget(l12, budget) == std::vector<std::string>{ "l12Exit", "worstWake" });
+
+    const LatencyFigures defaults = latencyFigures(createEEPROM(defaultConfig()));
+    budget.strict = true;
+    REQUIRE(checkLatencyBudget(defaults, budget) == std::vector<std::string>{ "defaults" });
+
+    REQUIRE(latencyToString(512) == "512ns");
+    REQUIRE(latencyToString(16500) == "16.5us");
+    REQUIRE(latencyToString(3100000) == "3100us");
+    REQUIRE(latencyToString(latency_unbounded) == "unbounded");
+}
+
+TEST_CASE("analyzeLatency", "[Latency]")
+{
+    const std::string directory = freshDirectory("lan7430-latency");
+    const EEPROM image = createEEPROM(defaultConfig());
+    writeEEPROMBatch(directory, image, stringToMac("00-02-01-23-10-00"), 4);
+    std::ofstream(directory + "/notes.txt") << "not an EEPROM";
+
+    std::vector<EEPROM> images{ image, createEEPROM(l12Config()), image };
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        images[i].mac = incrementMac(stringToMac("00-02-01-23-11-00"), i);
+    }
+    const std::string containerPath = directory + "/images.l7c";
+    writeEEPROMContainer(containerPath, images);
+    const std::string lotPath = directory + "/images.l7l";
+    const EepromLot lot(createEEPROM(l12Config()),
+                        { stringToMac("00-02-01-23-12-00"), stringToMac("00-02-01-23-12-01") });
+    writeEEPROMLot(lotPath, lot);
+
+    LatencyBudget budget;
+    budget.worstWake = 100000;
+    const LatencyAnalysis analysis = analyzeLatency({ directory }, budget, 4);
+    REQUIRE(analysis.files == 7);
+    REQUIRE(analysis.images == 9);
+    REQUIRE(analysis.violations == 3);
+    REQUIRE(analysis.skipped == std::vector<std::string>{ directory + "/notes.txt" });
+    REQUIRE(analysis.reports.size() == 4 + 2 + 1);
+
+    // sorted by location, the container images are grouped by their figures
+    REQUIRE(analysis.reports[4].location == containerPath);
+    REQUIRE(analysis.reports[4].images == 2);
+    REQUIRE(analysis.reports[4].violations.empty());
+    REQUIRE(analysis.reports[5].location == containerPath);
+    REQUIRE(analysis.reports[5].images == 1);
+    REQUIRE(analysis.reports[5].violations == std::vector<std::string>{ "worstWake" });
+    REQUIRE(analysis.reports[6].location == lotPath);
+    REQUIRE(analysis.reports[6].images == 2);
+
+    REQUIRE_THROWS_WITH(analyzeLatency({ "/does/not/exist" }, budget),
+                        ifm::error_type(ifm::FILE_PATH_DOESNT_EXIST).what());
+}
@@ -0,0 +1,203 @@
+/** @file 070-testServer.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/server.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+std::string socketPath()
+{
+    return std::filesystem::temp_directory_path().append("lan7430-server.sock").string();
+}
+
+int connectTo(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+    REQUIRE(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+    return fd;
+}
+
+void append(std::vector<Byte>& buffer, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const Byte*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void appendRequest(std::vector<Byte>& buffer, const EEPROM* eeprom, const Mac& mac)
+{
+    const uint32_t length = (eeprom != nullptr ? sizeof(EEPROM) : 0) + mac.size();
+    append(buffer, &length, sizeof(length));
+    if (eeprom != nullptr)
+    {
+        append(buffer, eeprom, sizeof(EEPROM));
+    }
+    append(buffer, mac.data(), mac.size());
+}
+
+void readAll(int fd, void* data, size_t size)
+{
+    auto* bytes = static_cast<Byte*>(data);
+    while (size > 0)
+    {
+        const ssize_t n = ::read(fd, bytes, size);
+        REQUIRE(n > 0);
+        bytes += n;
+        size -= n;
+    }
+}
+
+/// returns the status, \p eeprom is filled on success
+uint32_t readReply(int fd, EEPROM& eeprom)
+{
+    uint32_t length = 0;
+    uint32_t status = 0;
+    readAll(fd, &length, sizeof(length));
+    readAll(fd, &status, sizeof(status));
+    std::vector<Byte> payload(length - sizeof(status));
+    readAll(fd, payload.data(), payload.size());
+    if (status == ifm::IFM_NO_ERROR)
+    {
+        REQUIRE(payload.size() == sizeof(EEPROM));
+        std::memcpy(&eeprom, payload.data(), sizeof(EEPROM));
+    }
+    else
+    {
+        REQUIRE(std::string(payload.begin(), payload.end()) == ifm::error_type(status).what());
+    }
+    return status;
+}
+
+EEPROM createImage()
+{
+    EEPROM_CONFIG config;
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    return createEEPROM(config);
+}
+}  // namespace
+
+TEST_CASE("servePipelinedRequests", "[Server]")
+{
+    EepromServer server(socketPath());
+    std::thread thread([&server]() { server.run(); });
+
+    const EEPROM image = createImage();
+    const Mac macStart = stringToMac("00-02-01-23-10-00");
+    constexpr uint64_t count = 1000;
+
+    // the template only comes with the first request, all requests are sent before reading
+    std::vector<Byte> requests;
+    appendRequest(requests, &image, macStart);
+    for (uint64_t i = 1; i < count; ++i)
+    {
+        appendRequest(requests, nullptr, incrementMac(macStart, i));
+    }
+    const int fd = connectTo(socketPath());
+    ssize_t written = 0;
+    std::thread writer([&]() { written = ::write(fd, requests.data(), requests.size()); });
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        EEPROM eeprom{};
+        REQUIRE(readReply(fd, eeprom) == ifm::IFM_NO_ERROR);
+        EEPROM expected = image;
+        expected.mac = incrementMac(macStart, i);
+        REQUIRE(std::memcmp(&eeprom, &expected, sizeof(EEPROM)) == 0);
+    }
+    writer.join();
+    REQUIRE(written == static_cast<ssize_t>(requests.size()));
+    ::close(fd);
+
+    server.stop();
+    thread.join();
+    const ServerStatistics statistics = server.statistics();
+    REQUIRE(statistics.connections == 1);
+    REQUIRE(statistics.requests == count);
+    REQUIRE(statistics.errors == 0);
+    REQUIRE(statistics.p50 > std::chrono::nanoseconds(0));
+    REQUIRE(statistics.p50 <= statistics.p90);
+    REQUIRE(statistics.p90 <= statistics.p99);
+    REQUIRE(statistics.p99 <= statistics.p999);
+    REQUIRE(statistics.p999 <= statistics.max);
+}
+
+TEST_CASE("serveInvalidRequests", "[Server]")
+{
+    EepromServer server(socketPath());
+    std::thread thread([&server]() { server.run(); });
+
+    const EEPROM image = createImage();
+    std::vector<Byte> requests;
+    appendRequest(requests, nullptr, stringToMac("00-02-01-23-10-00"));
+    appendRequest(requests, &image, Mac{});
+    appendRequest(requests, nullptr, stringToMac("00-02-01-23-10-00"));
+    const uint32_t invalidLength = 3;
+    append(requests, &invalidLength, sizeof(invalidLength));
+    append(requests, "abc", invalidLength);
+
+    const int fd = connectTo(socketPath());
+    REQUIRE(::write(fd, requests.data(), requests.size()) == static_cast<ssize_t>(requests.size()));
+    EEPROM eeprom{};
+    REQUIRE(readReply(fd, eeprom) == ifm::SERVER_NO_TEMPLATE);
+    REQUIRE(readReply(fd, eeprom) == ifm::MAC_ADDRESS_INVALID);
+    REQUIRE(readReply(fd, eeprom) == ifm::IFM_NO_ERROR);
+    REQUIRE(readReply(fd, eeprom) == ifm::SERVER_INVALID_REQUEST);
+
+    // a length that can't be a request closes the connection
+    const uint32_t garbage = 0xffffffff;
+    REQUIRE(::write(fd, &garbage, sizeof(garbage)) == sizeof(garbage));
+    Byte byte = 0;
+    REQUIRE(::read(fd, &byte, 1) == 0);
+    ::close(fd);
+
+    // stop also closes connections that are still open
+    const int idle = connectTo(socketPath());
+    requests.clear();
+    appendRequest(requests, &image, stringToMac("00-02-01-23-10-00"));
+    REQUIRE(::write(idle, requests.data(), requests.size())
+            == static_cast<ssize_t>(requests.size()));
+    REQUIRE(readReply(idle, eeprom) == ifm::IFM_NO_ERROR);
+    server.stop();
+    thread.join();
+    REQUIRE(::read(idle, &byte, 1) == 0);
+    ::close(idle);
+    REQUIRE(server.statistics().connections == 2);
+    REQUIRE(server.statistics().errors == 3);
+}
+
+TEST_CASE("serveSocketPath", "[Server]")
+{
+    REQUIRE_THROWS_WITH(EepromServer("/tmp/this/is/some/random/path/to/nowhere.sock"),
+                        ifm::error_type(ifm::FOLDER_PATH_DOESNT_EXIST).what());
+
+    // a served socket and other files are not replaced
+    {
+        EepromServer server(socketPath());
+        REQUIRE_THROWS_WITH(EepromServer(socketPath()),
+                            ifm::error_type(ifm::SERVER_SOCKET_ERROR).what());
+    }
+    REQUIRE(!std::filesystem::exists(socketPath()));
+    std::ofstream(socketPath()) << "not a socket";
+    REQUIRE_THROWS_WITH(EepromServer(socketPath()),
+                        ifm::error_type(ifm::SERVER_SOCKET_ERROR).what());
+    std::filesystem::remove(socketPath());
+}
@@ -0,0 +1,307 @@
+/** @file 071-testStream.cpp
+ *
+ *  @brief
+ *
+ *  Copyright (C) 2020 ifm electronic GmbH
+ *  See accompanied file licence.txt for license information.
+ */
+
+#include "lan7430conf/errors.hpp"
+#include "lan7430conf/lan7430conf.hpp"
+#include "lan7430conf/stream.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+std::string macRecord(const Mac& mac)
+{
+    return "{\"mac\":\"" + macToString(mac) + "\",\"magic\":170,\"ledConfig\":[{\"control\":10}]}";
+}
+
+/// returns the status, \p image is filled on success
+uint32_t readFrame(std::istream& in, EEPROM& image)
+{
+    uint32_t length = 0;
+    uint32_t status = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    in.read(reinterpret_cast<char*>(&status), sizeof(status));
+    std::string payload(length - sizeof(status), '\0');
+    in.read(payload.data(), payload.size());
+    REQUIRE(in.good());
+    if (status == ifm::IFM_NO_ERROR)
+    {
+        REQUIRE(payload.size() == sizeof(EEPROM));
+        std::memcpy(&image, payload.data(), sizeof(EEPROM));
+    }
+    else
+    {
+        REQUIRE(payload == ifm::error_type(status).what());
+    }
+    return status;
+}
+
+/**
+ * @brief a pipe like the stdin of a live feed: reading blocks until the test feeds more input or
+ * closes it, only the fed bytes are available. Written data becomes visible on flush.
+ */
+class LiveBuffer : public std::streambuf
+{
+public:
+    void feed(const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_input += text;
+        m_changed.notify_all();
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_changed.notify_all();
+    }
+
+    /// waits until \p lines lines have been flushed, false on timeout
+    bool waitForLines(size_t lines)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_changed.wait_for(lock, std::chrono::seconds(10), [&]() {
+            return static_cast<size_t>(std::count(m_flushed.begin(), m_flushed.end(), '\n'))
+                   >= lines;
+        });
+    }
+
+protected:
+    int_type underflow() override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait_until(lock, std::chrono::steady_clock::time_point::max(), [this]() {
+            return m_closed || !m_input.empty();
+        });
+        if (m_input.empty())
+        {
+            return traits_type::eof();
+        }
+        m_current.swap(m_input);
+        m_input.clear();
+        setg(m_current.data(), m_current.data(), m_current.data() + m_current.size());
+        return traits_type::to_int_type(m_current.front());
+    }
+
+    std::streamsize showmanyc() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<std::streamsize>(m_input.size());
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            m_written += traits_type::to_char_type(c);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flushed += m_written;
+        m_written.clear();
+        m_changed.notify_all();
+        return 0;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::string m_input;
+    std::string m_current;
+    std::string m_written;
+    std::string m_flushed;
+    bool m_closed{ false };
+};
+
+std::string base64(const EEPROM& eeprom)
+{
+    static constexpr char table[]
+        = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const auto* bytes = reinterpret_cast<const Byte*>(&eeprom);
+    std::string encoded;
+    uint32_t bits = 0;
+    int count = 0;
+    for (size_t i = 0; i < sizeof(EEPROM); ++i)
+    {
+        bits = bits << 8 | bytes[i];
+        count += 8;
+        while (count >= 6)
+        {
+            count -= 6;
+            encoded += table[bits >> count & 0x3f];
+        }
+    }
+    if (count > 0)
+    {
+        encoded += table[bits << (6 - count) & 0x3f];
+    }
+    while (encoded.size() % 4 != 0)
+    {
+        encoded += '=';
+    }
+    return encoded;
+}
+}  // namespace
+
+TEST_CASE("applyNestedAndFlatRecords", "[Stream]")
+{
+    EEPROM_CONFIG nested{};
+    applyConfigRecord(R"({"mac":"00-02-01-23-10-55", "subsystemID": 4660,
+                          "ledConfig": [{}, {"enable": false, "control": 15}],
+                          "energyEfficientEthernet": false, "magic": 170})",
+                      nested);
+    EEPROM_CONFIG flat{};
+    applyConfigRecord(R"({"mac":"00:02:01:23:10:55","subsystemID":4660,)"
+                      R"("ledConfig[1].enable":false,"ledConfig[1].control":15,)"
+                      R"("energyEfficientEthernet":0,"magic":170})",
+                      flat);
+
+    REQUIRE(nested.mac == stringToMac("00-02-01-23-10-55"));
+    REQUIRE(nested.subsystemID == 0x1234);
+    REQUIRE(!nested.ledConfig[1].enable);
+    REQUIRE(nested.ledConfig[1].control == LED_CONTROL::FORCE_LED_ON);
+    REQUIRE(nested.ledConfig[0].control == EEPROM_CONFIG{}.ledConfig[0].control);
+    REQUIRE(!nested.energyEfficientEthernet);
+    REQUIRE(nested.magic == EEPROM_MAGIC::EEPROM_MAC);
+
+    const EEPROM eepromNested = createEEPROM(nested);
+    const EEPROM eepromFlat = createEEPROM(flat);
+    REQUIRE(std::memcmp(&eepromNested, &eepromFlat, sizeof(EEPROM)) == 0);
+}
+
+TEST_CASE("applyInvalidRecords", "[Stream]")
+{
+    const std::vector<std::pair<std::string, int>> records{
+        { "", ifm::STREAM_INVALID_RECORD },
+        { "[1, 2]", ifm::STREAM_INVALID_RECORD },
+        { R"({"subsystemID": 1)", ifm::STREAM_INVALID_RECORD },
+        { R"({"subsystemID": 1} x)", ifm::STREAM_INVALID_RECORD },
+        { R"({"subsystemID": tru})", ifm::STREAM_INVALID_RECORD },
+        { R"({"a":{"b":{"c":{"d":{"e":{"f":{"g":{"h":{"i":{}}}}}}}}}})",
+          ifm::STREAM_INVALID_RECORD },
+        { R"({"subsystemId": 1})", ifm::STREAM_UNKNOWN_MEMBER },
+        { R"({"ledConfig": [{}, {}, {}, {}, {"enable": true}]})", ifm::STREAM_UNKNOWN_MEMBER },
+        { R"({"subsystemID": 65536})", ifm::STREAM_INVALID_VALUE },
+        { R"({"subsystemID": -1})", ifm::STREAM_INVALID_VALUE },
+        { R"({"subsystemID": 1.5})", ifm::STREAM_INVALID_VALUE },
+        { R"({"subsystemID": "1"})", ifm::STREAM_INVALID_VALUE },
+        { R"({"subsystemID": true})", ifm::STREAM_INVALID_VALUE },
+        { R"({"subsystemID": null})", ifm::STREAM_INVALID_VALUE },
+        { R"({"ledConfig": [{"control": 16}]})", ifm::STREAM_INVALID_VALUE },
+        { R"({"mac": 1})", ifm::STREAM_INVALID_VALUE },
+        { R"({"mac": "00-02-01-23-10"})", ifm::MAC_ADDRESS_INVALID },
+        { R"({"mac": ""})", ifm::MAC_ADDRESS_EMPTY },
+    };
+    for (const auto& [record, code] : records)
+    {
+        INFO(record);
+        EEPROM_CONFIG config{};
+        REQUIRE_THROWS_WITH(applyConfigRecord(record, config), ifm::error_type(code).what());
+    }
+}
+
+TEST_CASE("streamBinary", "[Stream]")
+{
+    const Mac macStart = stringToMac("00-02-01-23-10-00");
+    constexpr uint64_t count = 1000;
+
+    // blank lines are skipped, but counted
+    std::stringstream in;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        in << macRecord(incrementMac(macStart, i)) << (i % 250 == 0 ? "\r\n\n" : "\n");
+    }
+    in << R"({"mac": "00-00-00-00-00-00"})";  // the last line may end without newline
+
+    std::stringstream out;
+    const StreamStatistics statistics
+        = streamEEPROMs(in, out, EEPROM_CONFIG{}, STREAM_FORMAT::BINARY, 2);
+    REQUIRE(statistics.records == count + 1);
+    REQUIRE(statistics.errors == 1);
+
+    EEPROM_CONFIG config{};
+    config.magic = EEPROM_MAGIC::EEPROM_MAC;
+    config.ledConfig[0].control = LED_CONTROL::ACTIVITY;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        EEPROM image{};
+        REQUIRE(readFrame(out, image) == ifm::IFM_NO_ERROR);
+        config.mac = incrementMac(macStart, i);
+        const EEPROM expected = createEEPROM(config);
+        REQUIRE(std::memcmp(&image, &expected, sizeof(EEPROM)) == 0);
+    }
+    EEPROM image{};
+    REQUIRE(readFrame(out, image) == ifm::MAC_ADDRESS_INVALID);
+    REQUIRE(out.peek() == std::char_traits<char>::eof());
+}
+
+TEST_CASE("streamJson", "[Stream]")
+{
+    EEPROM_CONFIG defaults{};
+    defaults.subsystemVendorID = 0x1e2a;
+
+    std::stringstream in;
+    in << macRecord(stringToMac("00-02-01-23-10-55")) << "\n";
+    in << "\n";
+    in << "{\"mac\":\"" << std::string(stream_max_record_len, ' ') << "\"}\n";
+    in << R"({"subsystemID": 65536})" << "\n";
+
+    std::stringstream out;
+    const StreamStatistics statistics = streamEEPROMs(in, out, defaults, STREAM_FORMAT::JSON);
+    REQUIRE(statistics.records == 3);
+    REQUIRE(statistics.errors == 2);
+
+    EEPROM_CONFIG config = defaults;
+    applyConfigRecord(macRecord(stringToMac("00-02-01-23-10-55")), config);
+    std::string line;
+    REQUIRE(std::getline(out, line));
+    REQUIRE(line
+            == R"({"record":1,"mac":"00-02-01-23-10-55","image":")"
+                   + base64(createEEPROM(config)) + "\"}");
+    REQUIRE(std::getline(out, line));
+    REQUIRE(line
+            == R"({"record":3,"error":7000,"message":")"
+                   + std::string(ifm::error_type(ifm::STREAM_INVALID_RECORD).what()) + "\"}");
+    REQUIRE(std::getline(out, line));
+    REQUIRE(line
+            == R"({"record":4,"error":7002,"message":")"
+                   + std::string(ifm::error_type(ifm::STREAM_INVALID_VALUE).what()) + "\"}");
+    REQUIRE(!std::getline(out, line));
+}
+
+TEST_CASE("streamLiveFeed", "[Stream]")
+{
+    // every record is answered before the next one is fed and long before the batch is full
+    LiveBuffer input;
+    LiveBuffer output;
+    std::istream in(&input);
+    std::ostream out(&output);
+    std::thread stream([&]() { streamEEPROMs(in, out, EEPROM_CONFIG{}, STREAM_FORMAT::JSON); });
+
+    bool answered = true;
+    for (size_t i = 0; i < 3 && answered; ++i)
+    {
+        input.feed(macRecord(incrementMac(stringToMac("00-02-01-23-10-00"), i)) + "\n");
+        answered = output.waitForLines(i + 1);
+    }
+    input.close();
+    stream.join();
+    REQUIRE(answered);
+}